@@ -4,8 +4,10 @@
 
 #include <array>
 #include <string>
-#include <unistd.h>  // pipe(), fork()
+#include <unistd.h>  // pipe2(), fork()
+#include <fcntl.h>  // O_CLOEXEC
 #include <sys/wait.h>  // waitpid()
+#include <signal.h>  // kill()
 
 #include "HTTPrequest.hpp"
 
@@ -16,11 +18,11 @@ public:
 
 	void						run();
 	bool 						waitCGIproc() const;
+	void						killCGIproc() const;
+	void						closeUploadReadEnd();
 	const std::array<int, 2> 	getUploadPipe() const;
 	const std::array<int, 2> 	getResponsePipe() const;
 	int 						getRequestSocket() const;
-	std::string 				getResponse() const;
-	void 						appendResponse(std::string additionalResponsePart);
 
 private:
 	const HTTPrequest                       &_req;
@@ -28,8 +30,8 @@ private:
 	char *const                             *_CgiEnvCStyle;
 	int                                     _uploadPipe[2];
 	int                                     _responsePipe[2];
-	std::string                             _response;
 	pid_t                                   _pid;
+	mutable bool                            _reaped;
 
 	std::array<std::string, CGI_ENV_SIZE> _createCgiEnv(const HTTPrequest &req);
 	char **_createCgiEnvCStyle();
@@ -0,0 +1,24 @@
+#pragma once
+#include <sys/types.h>		// ssize_t, off_t
+#include <cerrno>
+#include <cstring>			// strerror
+
+#include "Exceptions.hpp"
+#include "BufferChain.hpp"
+
+// producer of a response body, the response pulls it in bounded chunks so only
+// a fixed buffer per connection is held in memory whatever the payload size
+class BodySource
+{
+	public:
+		virtual ~BodySource( void ) {};
+
+		virtual ssize_t	read( char*, size_t ) =0;		// bytes produced, 0 when nothing is available now
+		virtual size_t	readInto( BufferChain&, size_t );
+		virtual ssize_t	sendTo( int, size_t );			// straight to the socket, only for direct sources
+		virtual bool	isDone( void ) const noexcept =0;
+		virtual bool	isDirect( void ) const noexcept;
+		virtual int		getFd( void ) const noexcept;
+		virtual off_t	getLength( void ) const noexcept;
+		virtual BodySource*	slice( off_t, off_t ) const;
+};
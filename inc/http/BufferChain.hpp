@@ -0,0 +1,42 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <memory>			// shared_ptr
+#include <cerrno>
+#include <algorithm>
+#include <sys/uio.h>		// writev
+#include <sys/socket.h>		// sendmsg
+
+#define CHAIN_IOV_MAX	64		// segments gathered per write
+
+// queue of shared byte blocks, written out with one gather call and advanced in place:
+// a block is never copied, partial writes only move the offset of the first segment
+class BufferChain
+{
+	public:
+		typedef std::shared_ptr<std::string const>	block_t;
+
+		BufferChain( void ) noexcept : _size(0) {};
+		~BufferChain( void ) {};
+
+		void	append( std::string&& );
+		void	append( block_t const&, size_t offset=0, size_t length=std::string::npos );
+		void	append( BufferChain&& );
+		ssize_t	writeTo( int, int flags=0 ) noexcept;
+		void	clear( void ) noexcept;
+
+		size_t	size( void ) const noexcept;
+		bool	empty( void ) const noexcept;
+
+	private:
+		typedef struct Segment
+		{
+			block_t	block;
+			size_t	offset, length;
+		}	t_Segment;
+
+		std::deque<t_Segment>	_segments;
+		size_t					_size;
+
+		void	_consume( size_t ) noexcept;
+};
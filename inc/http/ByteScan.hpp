@@ -0,0 +1,37 @@
+#pragma once
+#include <string_view>
+#include <cstring>			// memchr, memcmp
+
+#if defined(__x86_64__)
+# include <immintrin.h>
+# define BYTESCAN_X86
+#endif
+
+// delimiter search over request and CGI buffers, vector width picked once at start up
+class ByteScan
+{
+	public:
+		static char const*	find( char const*, size_t, char ) noexcept;
+		static char const*	find( char const*, size_t, std::string_view ) noexcept;
+		static size_t		find( std::string_view, char, size_t pos=0 ) noexcept;
+		static size_t		find( std::string_view, std::string_view, size_t pos=0 ) noexcept;
+		static char const*	getEngineName( void ) noexcept;
+
+	private:
+		typedef char const*	(*t_findByte)( char const*, size_t, char );
+		typedef char const*	(*t_findSeq)( char const*, size_t, std::string_view );
+
+		static t_findByte	_findByte;
+		static t_findSeq	_findSeq;
+		static char const*	_engineName;
+
+		static bool			_hasAVX2( void ) noexcept;
+		static char const*	_findByteScalar( char const*, size_t, char ) noexcept;
+		static char const*	_findSeqScalar( char const*, size_t, std::string_view ) noexcept;
+#ifdef BYTESCAN_X86
+		static char const*	_findByteSSE2( char const*, size_t, char ) noexcept;
+		static char const*	_findSeqSSE2( char const*, size_t, std::string_view ) noexcept;
+		static char const*	_findByteAVX2( char const*, size_t, char ) noexcept;
+		static char const*	_findSeqAVX2( char const*, size_t, std::string_view ) noexcept;
+#endif
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <limits>
+
+#include "Exceptions.hpp"
+#include "ByteScan.hpp"
+
+typedef enum ChunkState_f
+{
+	CHUNK_SIZE,
+	CHUNK_EXT,
+	CHUNK_SIZE_LF,
+	CHUNK_DATA,
+	CHUNK_DATA_CR,
+	CHUNK_DATA_LF,
+	CHUNK_TRAILER,
+	CHUNK_TRAILER_LINE,
+	CHUNK_TRAILER_LF,
+	CHUNK_DONE,
+}	ChunkState;
+
+// resumable decoder of a chunked body, keeps its state between reads
+class ChunkedDecoder
+{
+	public:
+		ChunkedDecoder( void ) noexcept;
+		~ChunkedDecoder( void ) {};
+
+		size_t	decode( char const*, size_t, std::string& );
+		void	reset( void ) noexcept;
+
+		void	setMaxSize( size_t ) noexcept;
+		bool	isDone( void ) const noexcept;
+		size_t	getDecodedSize( void ) const noexcept;
+
+	private:
+		ChunkState	_state;
+		size_t		_chunkSize, _sizeDigits, _decodedSize, _maxSize;
+
+		void	_endSizeLine( void );
+		static int	_hexValue( char ) noexcept;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <memory>			// shared_ptr
+#include <ctime>
+#include <fcntl.h>			// open
+#include <unistd.h>			// read, close
+#include <sys/stat.h>		// stat
+
+#include "BufferChain.hpp"
+#include "HTTPstruct.hpp"
+
+#define FILE_CACHE_MAX_FILE	(1 << 18)	// 256K, larger files are sent from disk
+#define FILE_CACHE_VALID	1			// seconds a cached file is trusted before it is checked again
+
+// small regular file held in memory along with the headers describing it
+typedef struct CachedFile
+{
+	BufferChain::block_t	body;
+	std::string				headers;		// Content-Length and Content-Type lines, rendered once
+	dev_t					device;
+	ino_t					inode;
+	struct timespec			mtime;
+	off_t					size;
+	std::time_t				checkedAt;
+} t_CachedFile;
+
+// per worker cache of static files keyed by resolved path, bounded in bytes with
+// LRU eviction; an evicted entry stays alive for the responses still sending it
+class FileCache
+{
+	public:
+		typedef std::shared_ptr<t_CachedFile const>	entry_t;
+
+		FileCache( size_t capacity ) noexcept : _capacity(capacity), _size(0) {};
+		~FileCache( void ) {};
+
+		entry_t	find( path_t const& );
+		entry_t	load( path_t const&, std::string const& );
+		void	forget( path_t const& ) noexcept;
+		bool	isEnabled( void ) const noexcept;
+		bool	canHold( off_t ) const noexcept;
+
+	private:
+		typedef struct Slot
+		{
+			std::shared_ptr<t_CachedFile>		entry;
+			std::list<std::string>::iterator	lru;
+		}	t_Slot;
+
+		size_t									_capacity, _size;
+		std::list<std::string>					_lru;			// most recently used first
+		std::unordered_map<std::string, t_Slot>	_entries;
+
+		void	_erase( std::unordered_map<std::string, t_Slot>::iterator ) noexcept;
+		static bool	_isSameFile( t_CachedFile const&, struct stat const& ) noexcept;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <unistd.h>				// pread, close
+#include <sys/sendfile.h>		// sendfile
+#include <algorithm>
+#include <memory>				// shared_ptr
+
+#include "BodySource.hpp"
+
+// fd of a regular file closed with its last user, transfers of the same file share it
+// since every read and sendfile passes its own offset
+class OpenFile
+{
+	public:
+		OpenFile( int fd ) noexcept : _fd(fd) {};
+		~OpenFile( void );
+		OpenFile( OpenFile const& ) = delete;
+		OpenFile&	operator=( OpenFile const& ) = delete;
+
+		int		getFd( void ) const noexcept;
+
+	private:
+		int		_fd;
+};
+
+// byte range of a regular file, sent from the page cache without copying
+class FileSource : public BodySource
+{
+	public:
+		FileSource( std::shared_ptr<OpenFile> file, off_t offset, off_t length ) : _file(file), _offset(offset), _end(offset + length) {};
+		virtual ~FileSource( void ) override {};
+
+		ssize_t	read( char*, size_t ) override;
+		ssize_t	sendTo( int, size_t ) override;
+		bool	isDone( void ) const noexcept override;
+		bool	isDirect( void ) const noexcept override;
+		off_t	getLength( void ) const noexcept override;
+		BodySource*	slice( off_t, off_t ) const override;
+
+	private:
+		std::shared_ptr<OpenFile>	_file;		// regular files are never registered in the poller
+		off_t						_offset, _end;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#include "BodySource.hpp"
+
+// body rendered piece by piece on demand, the generator appends the next
+// piece to its argument and returns false once there is nothing left
+class GeneratorSource : public BodySource
+{
+	public:
+		GeneratorSource( std::function<bool(std::string&)> generator ) : _generator(generator), _pos(0), _done(false) {};
+		virtual ~GeneratorSource( void ) override {};
+
+		ssize_t	read( char*, size_t ) override;
+		bool	isDone( void ) const noexcept override;
+
+	private:
+		std::function<bool(std::string&)>	_generator;
+		std::string							_piece;
+		size_t								_pos;
+		bool								_done;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <memory>			// shared_ptr
+
+#include "BufferChain.hpp"
+
+#define GZIP_CACHE_ENTRY_SHARE	4		// a variant larger than capacity / share is never kept
+
+// per worker cache of gzip variants keyed by resource and validator, so a changed file
+// gets a new key and its stale variant simply ages out; bounded in bytes with LRU eviction
+class GzipCache
+{
+	public:
+		typedef BufferChain::block_t	block_t;
+
+		GzipCache( size_t capacity ) noexcept : _capacity(capacity), _size(0) {};
+		~GzipCache( void ) {};
+
+		block_t	find( std::string const& );
+		void	store( std::string const&, std::string&& );
+		bool	isEnabled( void ) const noexcept;
+		bool	canHold( size_t ) const noexcept;
+
+	private:
+		typedef struct Slot
+		{
+			block_t								body;
+			std::list<std::string>::iterator	lru;
+		}	t_Slot;
+
+		size_t									_capacity, _size;
+		std::list<std::string>					_lru;			// most recently used first
+		std::unordered_map<std::string, t_Slot>	_entries;
+
+		void	_erase( std::unordered_map<std::string, t_Slot>::iterator ) noexcept;
+};
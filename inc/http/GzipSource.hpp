@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+#include "BodySource.hpp"
+#include "GzipCache.hpp"
+#include "HTTPstruct.hpp"
+
+#define GZIP_WINDOW_BITS	(15 + 16)	// 32K window, gzip wrapper instead of zlib's
+#define GZIP_MEM_LEVEL		8
+
+// deflates another source as it is read, the compressed length is only known at the
+// end so the response goes out chunked; zlib's state is allocated on the first read
+class GzipSource : public BodySource
+{
+	public:
+		GzipSource( BodySource* input, int level, off_t inputLength=-1 );
+		virtual ~GzipSource( void ) override;
+		GzipSource( GzipSource const& ) = delete;
+		GzipSource&	operator=( GzipSource const& ) = delete;
+
+		void	push( std::string_view );
+		void	keepIn( GzipCache*, std::string const& );
+
+		ssize_t	read( char*, size_t ) override;
+		bool	isDone( void ) const noexcept override;
+		int		getFd( void ) const noexcept override;
+
+	private:
+		BodySource	*_input;		// owned
+		z_stream	_stream;
+		int			_level;
+		bool		_started, _finished, _unflushed;
+		off_t		_inputLeft;		// bytes the input may still give, -1 when unbounded
+		std::string	_inBuf;			// input not deflated yet
+		size_t		_inPos;
+		GzipCache	*_cache;		// nullptr: the output isn't kept
+		std::string	_key, _kept;
+
+		bool	_isInputDone( void ) const noexcept;
+		void	_refill( void );
+		void	_keep( char const*, size_t );
+};
@@ -3,12 +3,21 @@
 #include <sys/types.h>        // send, recv
 #include <sys/socket.h>       // send, recv
 #include <fstream>
+#include <charconv>		// from_chars
+#include <unistd.h>			// write, close
+#include <fcntl.h>			// open, O_TMPFILE
+#include <cstdlib>			// mkstemp
 
 #include "HTTPstruct.hpp"
 #include "Config.hpp"
 #include "RequestValidate.hpp"
+#include "RequestParser.hpp"
+#include "ChunkedDecoder.hpp"
+#include "RingBuffer.hpp"
 
 #define HTTP_MAX_HEADER_SIZE	8192
+#define HTTP_BODY_TEMP_DIR		"/tmp"		// where request bodies larger than client_body_buffer_size are spilled
+#define HTTP_BODY_RING_SIZE		65536		// body bytes held between the socket and the CGI, same as a pipe
 
 typedef enum HTTPreqState_f
 {
@@ -35,14 +44,25 @@ typedef std::vector<Config> t_serv_list;
 class HTTPrequest : public HTTPstruct
 {
 	public:
-		HTTPrequest( int socket, t_serv_list const& servers ) :
+		HTTPrequest( int socket, t_serv_list const& servers, std::string pending=std::string(), OpenFileCache* openFiles=nullptr ) :
 			HTTPstruct(socket, 200, HTTP_STATIC),
 			_state(HTTP_REQ_HEAD_READING),
 			_method(HTTP_GET),
-			_validator(servers),
+			_validator(servers, openFiles),
+			_headLength(0),
+			_chunked(false),
+			_endConn(false),
+			_pending(std::move(pending)),
+			_pendingPos(0),
 			_contentLength(0) ,
-			_maxBodySize(-1) {};
-		virtual ~HTTPrequest( void ) override {};
+			_maxBodySize(-1),
+			_bodyReceived(0),
+			_bodyBufferSize(-1),
+			_bodyFd(-1),
+			_bodySent(0) {};
+		HTTPrequest( HTTPrequest const& ) = delete;				// parsed views point into _headBuf
+		HTTPrequest& operator=( HTTPrequest const& ) = delete;
+		virtual ~HTTPrequest( void ) override;
 
 		void		parseHead( void );
 		void		parseBody( void );
@@ -53,19 +73,38 @@ class HTTPrequest : public HTTPstruct
 		std::string			getHost( void ) const noexcept;
 		std::string		 	getPort( void ) const noexcept;
 		size_t			 	getContentLength( void ) const noexcept;
+		int					getBodyFd( void ) const noexcept;
 		std::string	const&	getQueryRaw( void ) const noexcept;
 		std::string	const	getCookie( void ) const noexcept;
 		std::string			getContentTypeBoundary( void ) const noexcept;
+		std::string_view	getIfNoneMatch( void ) const noexcept;
+		std::string_view	getIfModifiedSince( void ) const noexcept;
+		std::string_view	getRange( void ) const noexcept;
+		std::string_view	getIfRange( void ) const noexcept;
+		uint8_t				getStaticCodings( void ) const noexcept;
+		uint8_t				getAcceptedCodings( void ) const noexcept;
+		t_GzipConf const&	getGzip( void ) const noexcept;
+		t_TypesConf const&	getTypesConf( void ) const noexcept;
+		std::string			takeSurplus( void ) noexcept;
 		std::string const&	getServName( void ) const noexcept;
+		std::string const&	getServerHeader( void ) const noexcept;
 		path_t const&		getRealPath( void ) const noexcept;
 		path_t const&		getRedirectPath( void ) const noexcept;
 		path_t const&		getRoot( void ) const noexcept;
 
-		bool	isEndConn( void ) noexcept;
+		bool	isEndConn( void ) const noexcept;
 		bool	isChunked( void ) const noexcept;
 		bool	isDoneReadingHead( void ) const noexcept;
 		bool	isDoneReadingBody( void ) const noexcept;
 		bool	hasBodyToRead( void ) const noexcept;
+		bool	isBodyLeftUnread( void ) const noexcept;
+		bool	hasPendingInput( void ) const noexcept;
+		bool	isBodyBuffered( void ) const noexcept;
+		bool	isBodySpilled( void ) const noexcept;
+		bool	isBodyStreamed( void ) const noexcept;
+		bool	canReadBody( void ) const noexcept;
+		bool	hasBodyToWrite( void ) const noexcept;
+		ssize_t	writeBody( int );
 
 	protected:
 		HTTPreqState	_state;
@@ -74,13 +113,31 @@ class HTTPrequest : public HTTPstruct
 
 		RequestValidate	_validator;
 
-		std::string _tmpHead;
-		size_t		_contentLength, _maxBodySize;
-
-		void		_setHead( std::string const& ) override;
-		void		_setHeaders(std::string const& ) override;
+		RequestParser	_parser;
+		char			_headBuf[HTTP_MAX_HEADER_SIZE];		// receive buffer of the head, parsed in place
+		size_t			_headLength;
+		std::string_view	_hostName, _hostPort;		// Host header, split once
+		bool			_chunked, _endConn;
+		ChunkedDecoder	_decoder;
+		std::string		_pending;		// bytes of the connection read before this request started, consumed before recv
+		size_t			_pendingPos;
+		std::string		_surplus;		// bytes read past the end of this request, they belong to the next one
+		size_t			_contentLength, _maxBodySize, _bodyReceived;
+		size_t			_bodyBufferSize;		// client_body_buffer_size of the location
+		int				_bodyFd;				// unlinked temp file holding the body once it outgrew _bodyBufferSize
+		RingBuffer		_bodyRing;				// streamed body on its way to the CGI
+		size_t			_bodySent;				// bytes of a buffered body already given to the CGI
+
+		void		_resolveHeaders( void ) noexcept;
+		void		_setHead( void );
+		void		_checkHeaders( void );
 		void		_setVersion( std::string const& ) override;
 		void		_setBody( std::string const& ) override;
+		ssize_t		_receive( char*, size_t );
+		void		_takeBodyBytes( char const*, size_t );
+		void		_setBodyBuffering( void );
+		void		_spillBody( void );
+		static int	_openTempFile( void );
 		void		_readHead( void );
 		void		_readBody( void );
 		void		_setTypeAndState( void ) noexcept;
@@ -88,7 +145,7 @@ class HTTPrequest : public HTTPstruct
 		std::string	_encodeSpaces( std::string const&) const noexcept;
 		std::string	_decodeSpaces( std::string const&) const noexcept;
 
-		void	_setMethod( std::string const& );
+		void	_setMethod( std::string_view );
 		void	_setURL( std::string const& );
 		void	_setScheme( std::string const& );
 		void	_setHostPort( std::string const& );
@@ -96,5 +153,4 @@ class HTTPrequest : public HTTPstruct
 		void	_setQuery( std::string const& );
 		void	_setFragment( std::string const& );
 	
-		std::string	_unchunkBody( std::string const& );
 };
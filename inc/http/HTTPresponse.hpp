@@ -4,18 +4,36 @@
 #include <sys/socket.h>       	// send, recv
 #include <unistd.h>				// read
 #include <fcntl.h>
+#include <sys/stat.h>			// fstat
 #include <set>
 #include <cmath>
+#include <charconv>				// to_chars
 
 #include "HTTPstruct.hpp"
+#include "BufferChain.hpp"
+#include "MemorySource.hpp"
+#include "FileSource.hpp"
+#include "PipeSource.hpp"
+#include "GeneratorSource.hpp"
+#include "SequenceSource.hpp"
+#include "GzipSource.hpp"
+#include "GzipCache.hpp"
+#include "FileCache.hpp"
+#include "OpenFileCache.hpp"
+#include "Parameters.hpp"
+#include "ResponseHead.hpp"
 
-#define HTML_CONTENT_TYPE	std::string("text/html; charset=utf-8")
-#define CSS_CONTENT_TYPE	std::string("text/css")
-#define JS_CONTENT_TYPE		std::string("text/javascript")
-#define PLAIN_CONTENT_TYPE	std::string("text/plain")
-#define JPG_CONTENT_TYPE	std::string("image/jpeg")
-#define PNG_CONTENT_TYPE	std::string("image/png")
-#define ICO_CONTENT_TYPE	std::string("image/vnd.microsoft.icon")
+#define LISTING_CONTENT_TYPE	"text/html"		// directory listings, whatever the types say
+#define SENDFILE_CHUNK		(1 << 20)		// bytes handed to sendfile per POLLOUT, keeps one download from starving the loop
+#define RESP_BUF_SIZE		(1 << 16)		// 64K, bytes queued per response: high watermark of the source
+#define RESP_LOW_WATERMARK	4				// the source is read again once the buffer drains below 1/4
+#define CHUNK_OVERHEAD		20				// size line and CRLFs framing one chunk
+#define HTTP_LAST_CHUNK		std::string("0\r\n\r\n")
+#define CGI_HEAD_MAX		(HTTP_BUF_SIZE * 2)		// 16K, headers of a CGI response
+#define RANGE_MAX_PARTS		16				// more ranges in one request and the whole file is sent
+#define RANGE_UNIT			std::string_view("bytes")
+
+typedef std::pair<off_t, off_t>	t_Range;		// first and last byte, both included
 
 #define ERROR_500_CONTENT	"<!DOCTYPE html>\r\n<html>\r\n\t<head>\r\n\t\t<meta http-equiv=\"content-type\" content=\"text/html; charset=UTF-8\">\r\n\t\t<title>500 - Internal Server Error</title>\r\n\t</head>\r\n\r\n\t<body>\r\n\t\t<div id=\"app\">\r\n\t\t\t<div>500</div>\r\n\t\t\t<div class=\"txt\">\r\n\t\t\t\tInternal Server Error<span class=\"blink\"></span>\r\n\t\t\t</div>\r\n\t\t\t<a href=\"/\">go home</a>\r\n\t\t</div>\r\n\t</body>\r\n</html>"
 
@@ -31,32 +49,74 @@ class HTTPresponse : public HTTPstruct
 {
 	public:
 		HTTPresponse( int, int, HTTPtype type=HTTP_STATIC);
-		virtual ~HTTPresponse( void ) override {};
+		virtual ~HTTPresponse( void ) override;
 
-		void		parseCGI( std::string const& );
-		void		parseNotCGI( std::string const& );
-		void		readStaticFile( void );
+		void		parseNotCGI( std::string const& serverLine );
+		void		fillBody( void );
 		void		listContentDirectory( void );
 		void		removeFile( void ) const;
 		void		writeContent( void ) ;
 		void		errorReset( int, bool hardCode ) noexcept;
+		bool		checkConditions( std::string_view, std::string_view );
+		void		setRanges( std::string_view, std::string_view );
 		std::string	toString( void ) const noexcept override;
 
 		int			getHTMLfd( void ) const noexcept;
-		void		setTargetFile( path_t const& );
-		bool		isDoneReadingHTML( void ) const noexcept;
+		int			getBodyFd( void ) const noexcept;
+		void		setTargetFile( path_t const&, FileCache* cache=nullptr, OpenFileCache* openFiles=nullptr, uint8_t staticCodings=0, uint8_t acceptedCodings=0 );
+		void		setBodySource( BodySource* );
+		void		setCompression( t_GzipConf const*, bool, GzipCache* cache=nullptr ) noexcept;
+		void		setContentTypes( MimeTypes const*, t_TypesConf const* ) noexcept;
 		bool		isParsingNeeded( void ) const noexcept;
 		bool		isDoneWriting( void ) const noexcept;
+		bool		hasStartedWriting( void ) const noexcept;
+		bool		isBodyProduced( void ) const noexcept;
+		bool		isBodyBufferFull( void ) const noexcept;
+		bool		isWaitingForBody( void ) const noexcept;
+		bool		needsBody( void ) const noexcept;
 
 	protected:
 		HTTPrespState	_state;
 		path_t			_targetFile;
-		int				_HTMLfd;
+		int				_HTMLfd;					// static file polled by the server, -1 otherwise
+		BodySource		*_source;					// nullptr for a bodyless response
+		FileCache::entry_t	_cachedFile;			// set when the body is served from the file cache
+		BufferChain		_output;					// head and body segments not sent yet
+		off_t			_bodyLength, _bodyQueued;	// length -1: unknown, sent chunked
+		bool			_bodyComplete;				// every body byte (and the last chunk) is queued
 		size_t			_contentLengthWrite;
-		std::string		_contentType, _strSelf;
+		std::string		_contentType;				// overrides the type guessed from the file name
+		std::string_view	_contentEncoding;		// coding of the precompressed sibling sent instead of the file
+		bool			_varyEncoding;				// the representation depends on Accept-Encoding
+		t_GzipConf const	*_gzip;					// on the fly compression of the location, nullptr: none
+		bool			_gzipAccepted;				// the client takes gzip
+		GzipCache		*_gzipCache;				// compressed static files of the worker
+		std::string_view	_serverLine;			// pre-rendered Server line of the vhost, the CGI sends its own
+		std::string_view	_typeLine;				// pre-rendered Content-Type line of a type without charset
+		MimeTypes const		*_mimeTypes;			// registry of the server, nullptr: the built-in one
+		t_TypesConf const	*_typesConf;			// default_type and charset of the location, nullptr: defaults
+		std::string		_etag;						// validators of a static file, empty otherwise
+		std::time_t		_lastModified;
 
 		void		_setHeaders( std::string const& ) override;
-		std::string	_mapStatusCode( int ) const ;
-		std::string	_getDateTime( void ) const noexcept;
+		void		_readCGIhead( void );
+		GzipSource*	_parseCGIhead( std::string const& );
+		size_t		_getBodyRoom( void ) const noexcept;
+		void		_queueBody( BufferChain&& );
+		bool		_isDirectBodyNext( void ) const noexcept;
+		path_t		_findPrecompressed( path_t const&, uint8_t, OpenFileCache* );
+		GzipSource*	_compressBody( std::string const& );
+		void		_addEncodingHeaders( void );
+		void		_setValidators( ino_t, off_t, struct timespec const& );
+		bool		_matchesETag( std::string_view ) const noexcept;
+		bool		_matchesIfRange( std::string_view ) const noexcept;
+		void		_setMultipartBody( std::vector<t_Range> const&, off_t );
+		static bool	_parseRanges( std::string_view, off_t, std::vector<t_Range>& ) noexcept;
+		static std::string	_getContentRange( t_Range const&, off_t );
+		bool		_isBodySent( void ) const noexcept;
+		std::string	_getDateTime( std::time_t now=std::time(nullptr) ) const noexcept;
 		std::string	_getContTypeFromFile( path_t const& ) const noexcept;
+		std::string_view	_getContTypeLine( path_t const& ) const noexcept;
+		t_MimeType const&	_findType( path_t const& ) const noexcept;
+		bool		_takesCharset( std::string const& ) const noexcept;
 };
@@ -6,9 +6,10 @@
 #include <algorithm>
 #include <vector>
 #include <filesystem>
-#include <chrono>			// timeout handling
 
 #include "Exceptions.hpp"
+#include "HeaderTable.hpp"
+#include "ByteScan.hpp"
 
 #define LOCALHOST			std::string("localhost")
 #define HTTP_DEF_PORT		std::string("8080")				// default port, 80 for sudo, 8080 for users
@@ -19,7 +20,6 @@
 #define HTTP_SP				std::string(" ")				// shortcut for space
 #define HTTP_DEF_VERSION	HTTP_DEF_SCHEME + std::string("/1.1")
 #define HTTP_BUF_SIZE 		8192							// 8K
-#define HTTP_MAX_TIMEOUT	10
 
 // request headers
 #define	HTTP_HEADER_CONT_LEN		"Content-Length"
@@ -28,13 +28,22 @@
 #define	HTTP_HEADER_CONN			"Connection"
 #define	HTTP_HEADER_TRANS_ENCODING	"Transfer-Encoding"
 #define	HTTP_HEADER_COOKIE			"Cookie"
+#define	HTTP_HEADER_IF_NONE_MATCH	"If-None-Match"
+#define	HTTP_HEADER_IF_MOD_SINCE	"If-Modified-Since"
+#define	HTTP_HEADER_RANGE			"Range"
+#define	HTTP_HEADER_IF_RANGE		"If-Range"
+#define	HTTP_HEADER_ACCEPT_ENCODING	"Accept-Encoding"
 // response headers
 #define HTTP_HEADER_STATUS			"Status"
 #define HTTP_HEADER_DATE			"Date"
 #define HTTP_HEADER_SERVER			"Server"
 #define HTTP_HEADER_LOC				"Location"
-
-using namespace std::chrono;
+#define HTTP_HEADER_ETAG			"ETag"
+#define HTTP_HEADER_LAST_MOD		"Last-Modified"
+#define HTTP_HEADER_ACCEPT_RANGES	"Accept-Ranges"
+#define HTTP_HEADER_CONT_RANGE		"Content-Range"
+#define HTTP_HEADER_CONT_ENCODING	"Content-Encoding"
+#define HTTP_HEADER_VARY			"Vary"
 
 typedef std::multimap<std::string, std::string> t_dict;
 typedef std::filesystem::path path_t;
@@ -46,6 +55,13 @@ typedef enum HTTPmethod_s
 	HTTP_DELETE,
 }	HTTPmethod;
 
+// content codings of the precompressed siblings of a static file, combined as a mask
+typedef enum ContentCoding_s
+{
+	CODING_GZIP = 1 << 0,
+	CODING_BR = 1 << 1,
+}	ContentCoding;
+
 typedef enum HTTPtype_s
 {
 	HTTP_STATIC,
@@ -70,7 +86,7 @@ class HTTPstruct
 			_socket(socket),
 			_statusCode(statusCode),
 			_type(type),
-			_version({HTTP_DEF_SCHEME, 1, 1}) {_resetTimeout();}
+			_version({HTTP_DEF_SCHEME, 1, 1}) {};
 		virtual	~HTTPstruct( void ) {};
 
 		virtual std::string	toString( void ) const noexcept =0;
@@ -95,20 +111,15 @@ class HTTPstruct
 		int			_socket, _statusCode;
 		HTTPtype	_type;
 
-		t_dict 		_headers;
+		HeaderTable	_headers;
 		std::string	_tmpBody, _body;
     	HTTPversion	_version;
 		path_t		_root;
 
-		steady_clock::time_point	_lastActivity;
-
 		virtual void	_setHead( std::string const& ) {};
 		virtual void	_setHeaders( std::string const& );
 		virtual void	_setVersion( std::string const& );
 		virtual void	_setBody( std::string const& tmpBody );
 
-		void	_resetTimeout( void ) noexcept;
-		void	_checkTimeout( void );
-
-		void	_addHeader(std::string const&, std::string const& ) noexcept;
+		void	_addHeader(std::string const&, std::string const& );
 	};
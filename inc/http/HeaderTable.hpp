@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>		// remove_if
+#include <strings.h>		// strncasecmp
+
+#define HEADER_TABLE_RESERVE	16		// fields stored before the table has to grow
+
+typedef struct Header
+{
+	std::string	name;
+	std::string	value;
+} t_Header;
+
+// flat list of header fields in insertion order, names compared case-insensitively
+class HeaderTable
+{
+	public:
+		HeaderTable( void ) {};
+		~HeaderTable( void ) {};
+
+		void				add( std::string const&, std::string const& );
+		void				clear( void ) noexcept;
+		void				erase( std::string_view ) noexcept;
+		bool				has( std::string_view ) const noexcept;
+		std::string const*	find( std::string_view ) const noexcept;
+		bool				empty( void ) const noexcept;
+
+		std::vector<t_Header>::const_iterator	begin( void ) const noexcept;
+		std::vector<t_Header>::const_iterator	end( void ) const noexcept;
+
+		static bool	equalNames( std::string_view, std::string_view ) noexcept;
+
+	private:
+		std::vector<t_Header>	_fields;
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <algorithm>
+
+#include "BodySource.hpp"
+
+// body already held in memory, its block is shared with the response output instead of copied
+class MemorySource : public BodySource
+{
+	public:
+		MemorySource( std::string const& bytes ) : _bytes(std::make_shared<std::string const>(bytes)), _pos(0), _end(_bytes->size()) {};
+		MemorySource( BufferChain::block_t const& bytes, size_t offset=0, size_t length=std::string::npos ) :
+			_bytes(bytes), _pos(offset), _end(offset + std::min(length, bytes->size() - offset)) {};
+		virtual ~MemorySource( void ) override {};
+
+		ssize_t		read( char*, size_t ) override;
+		size_t		readInto( BufferChain&, size_t ) override;
+		bool		isDone( void ) const noexcept override;
+		off_t		getLength( void ) const noexcept override;
+		BodySource*	slice( off_t, off_t ) const override;
+
+	private:
+		BufferChain::block_t	_bytes;
+		size_t					_pos, _end;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <memory>			// shared_ptr
+#include <ctime>
+#include <fcntl.h>			// open
+#include <sys/stat.h>		// stat
+
+#include "HTTPstruct.hpp"
+#include "FileSource.hpp"
+
+// what the server needs to know about a path, a missing file is described as well
+typedef struct FileInfo
+{
+	bool			exists;
+	mode_t			mode;
+	off_t			size;
+	dev_t			device;
+	ino_t			inode;
+	struct timespec	mtime;
+	path_t			realPath;		// weakly canonical form
+}	t_FileInfo;
+
+// per worker cache of stat results and open fds keyed by path (open_file_cache): an entry is
+// trusted for `valid` seconds before being checked again, dropped after `inactive` seconds
+// without use or when more than `maxEntries` paths are held; a dropped fd stays open until
+// the transfers sharing it are done. Missing files are not cached, a new upload shows up at once
+class OpenFileCache
+{
+	public:
+		typedef std::shared_ptr<OpenFile>	file_t;
+
+		OpenFileCache( size_t maxEntries, std::time_t inactive, std::time_t valid ) noexcept :
+			_maxEntries(maxEntries), _inactive(inactive), _valid(valid) {};
+		~OpenFileCache( void ) {};
+
+		t_FileInfo	getInfo( path_t const& );
+		file_t		open( path_t const&, t_FileInfo& );
+		void		forget( path_t const& ) noexcept;
+		bool		isEnabled( void ) const noexcept;
+
+		static t_FileInfo	readInfo( path_t const& );
+		static file_t		openFile( path_t const& ) noexcept;
+
+	private:
+		typedef struct Entry
+		{
+			t_FileInfo							info;
+			file_t								file;		// opened on the first transfer, regular files only
+			std::time_t							checkedAt, usedAt;
+			std::list<std::string>::iterator	lru;
+		}	t_Entry;
+
+		size_t										_maxEntries;
+		std::time_t									_inactive, _valid;
+		std::list<std::string>						_lru;			// most recently used first
+		std::unordered_map<std::string, t_Entry>	_entries;
+
+		t_Entry*	_lookup( path_t const& );
+		void		_expire( std::time_t ) noexcept;
+		void		_erase( std::unordered_map<std::string, t_Entry>::iterator ) noexcept;
+		static bool	_isSameFile( t_FileInfo const&, t_FileInfo const& ) noexcept;
+};
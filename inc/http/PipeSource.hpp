@@ -0,0 +1,20 @@
+#pragma once
+#include <unistd.h>			// read
+
+#include "BodySource.hpp"
+
+// non blocking fd polled by the server (CGI output, fifo), read as the bytes arrive
+class PipeSource : public BodySource
+{
+	public:
+		PipeSource( int fd ) : _fd(fd), _done(false) {};
+		virtual ~PipeSource( void ) override {};
+
+		ssize_t	read( char*, size_t ) override;
+		bool	isDone( void ) const noexcept override;
+		int		getFd( void ) const noexcept override;
+
+	private:
+		int		_fd;			// closed by the server along with its poll slot
+		bool	_done;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <string_view>
+#include <array>
+
+#include "Exceptions.hpp"
+#include "HeaderTable.hpp"
+#include "ByteScan.hpp"
+
+#define HTTP_MAX_HEADERS	64		// header fields kept per request
+
+typedef struct HeaderView
+{
+	std::string_view	name;
+	std::string_view	value;
+} t_HeaderView;
+
+// headers the server reads on every request, resolved once while parsing
+typedef enum HeaderId_f
+{
+	HDR_HOST,
+	HDR_CONT_LEN,
+	HDR_CONT_TYPE,
+	HDR_CONN,
+	HDR_TRANS_ENCODING,
+	HDR_COOKIE,
+	HDR_IF_NONE_MATCH,
+	HDR_IF_MOD_SINCE,
+	HDR_RANGE,
+	HDR_IF_RANGE,
+	HDR_ACCEPT_ENCODING,
+	HDR_KNOWN_COUNT,
+}	HeaderId;
+
+typedef enum ParserState_f
+{
+	PARSE_REQ_LINE,
+	PARSE_HEADER_LINE,
+	PARSE_DONE,
+}	ParserState;
+
+// resumable parser of a request head, the views point into the caller's buffer
+class RequestParser
+{
+	public:
+		RequestParser( void ) noexcept;
+		~RequestParser( void ) {};
+
+		bool	feed( char const*, size_t );
+		void	reset( void ) noexcept;
+
+		bool					isDone( void ) const noexcept;
+		size_t					getHeadSize( void ) const noexcept;
+		std::string_view		getMethod( void ) const noexcept;
+		std::string_view		getTarget( void ) const noexcept;
+		std::string_view		getVersion( void ) const noexcept;
+		bool					hasHeader( HeaderId ) const noexcept;
+		std::string_view		getHeader( HeaderId ) const noexcept;
+		bool					hasHeader( std::string_view ) const noexcept;
+		std::string_view		getHeader( std::string_view ) const noexcept;
+		size_t					getHeadersCount( void ) const noexcept;
+		t_HeaderView const&		getHeaderAt( size_t ) const noexcept;
+
+	private:
+		ParserState								_state;
+		size_t									_pos, _lineStart;
+		std::string_view						_method, _target, _version;
+		std::array<t_HeaderView, HTTP_MAX_HEADERS>	_headers;
+		size_t									_nHeaders;
+		std::array<int, HDR_KNOWN_COUNT>		_known;		// index in _headers, -1 when missing
+
+		void	_parseRequestLine( std::string_view );
+		void	_parseHeaderLine( std::string_view );
+		static std::string_view	_trimOWS( std::string_view ) noexcept;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <string_view>
+#include <array>
+#include <ctime>
+#include <cstdint>
+
+#define STATUS_CODE_END	600		// codes of the status table are below it
+#define DATE_LINE_SIZE	64
+
+// pieces of a response head rendered ahead of time: status lines come from a table built
+// at compile time, the Date line is formatted once per second by each worker's event loop
+class ResponseHead
+{
+	public:
+		static std::string_view	statusLine( int ) noexcept;
+		static std::string_view	dateLine( void ) noexcept;
+		static void				refreshDate( std::time_t ) noexcept;
+
+	private:
+		static thread_local char		_dateLine[DATE_LINE_SIZE];
+		static thread_local size_t		_dateLength;
+		static thread_local std::time_t	_dateSecond;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstring>			// memcpy
+#include <cerrno>
+#include <sys/uio.h>		// writev
+
+// fixed size byte queue, bytes are written out straight from its storage
+class RingBuffer
+{
+	public:
+		RingBuffer( void ) noexcept : _start(0), _size(0) {};
+		~RingBuffer( void ) {};
+
+		void	reserve( size_t );
+		size_t	push( char const*, size_t ) noexcept;
+		ssize_t	writeTo( int ) noexcept;
+
+		size_t	size( void ) const noexcept;
+		size_t	space( void ) const noexcept;
+		bool	empty( void ) const noexcept;
+		bool	full( void ) const noexcept;
+
+	private:
+		std::vector<char>	_data;
+		size_t				_start, _size;
+};
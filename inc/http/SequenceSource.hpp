@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+
+#include "BodySource.hpp"
+
+// sources sent one after the other as a single body (multipart/byteranges), owns them
+class SequenceSource : public BodySource
+{
+	public:
+		SequenceSource( void ) : _current(0) {};
+		virtual ~SequenceSource( void ) override;
+		SequenceSource( SequenceSource const& ) = delete;
+		SequenceSource&	operator=( SequenceSource const& ) = delete;
+
+		void	append( BodySource* );
+
+		ssize_t	read( char*, size_t ) override;
+		size_t	readInto( BufferChain&, size_t ) override;
+		bool	isDone( void ) const noexcept override;
+		off_t	getLength( void ) const noexcept override;
+
+	private:
+		std::vector<BodySource*>	_parts;
+		size_t						_current;
+
+		void	_skipDone( void ) noexcept;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>		// hardware_concurrency
+#include <algorithm>
+#include <ctime>
+
+#include "Exceptions.hpp"
+#include "Parameters.hpp"
+
+typedef std::vector<std::string> strings_t;
+
+typedef enum PollerEngine_s
+{
+	ENGINE_EPOLL,
+	ENGINE_POLL,
+	ENGINE_IO_URING,
+}	PollerEngine;
+
+#define DEF_ENGINE ENGINE_EPOLL
+#define DEF_WORKERS 1
+#define MAX_WORKERS 256
+#define DEF_CPU_AFFINITY false
+#define DEF_FILE_CACHE_SIZE (1 << 20)	// 1M per worker
+#define DEF_GZIP_CACHE_SIZE (1 << 20)	// 1M per worker
+#define DEF_OPEN_FILE_CACHE_MAX 1000
+#define DEF_OPEN_FILE_CACHE_INACTIVE 20	// seconds
+#define DEF_OPEN_FILE_CACHE_VALID 1		// seconds
+
+class Events
+{
+	public:
+		Events(void);
+		Events(const Events& copy);
+		Events&	operator=(const Events& assign);
+		virtual ~Events(void);
+
+		void			parseBlock(strings_t& block);
+		PollerEngine	getEngine(void) const;
+		size_t			getWorkers(void) const;
+		bool			getCpuAffinity(void) const;
+		size_t			getFileCacheSize(void) const;
+		size_t			getGzipCacheSize(void) const;
+		size_t			getOpenFileCacheMax(void) const;
+		std::time_t		getOpenFileCacheInactive(void) const;
+		std::time_t		getOpenFileCacheValid(void) const;
+
+	private:
+		PollerEngine	engine; // event notification backend used by the server loop
+		size_t			workers; // number of event loops, each one running in its own thread
+		bool			cpu_affinity; // pin every worker to a different core
+		size_t			file_cache_size; // bytes of small static files each worker keeps in memory, 0 disables it
+		size_t			gzip_cache_size; // bytes of compressed static files each worker keeps in memory, 0 disables it
+		size_t			open_file_cache_max; // paths whose stat and fd each worker keeps, 0 disables it
+		std::time_t		open_file_cache_inactive; // seconds without use before an entry is dropped
+		std::time_t		open_file_cache_valid; // seconds an entry is trusted before it is checked again
+
+		void	_parseUse(strings_t& block);
+		void	_parseWorkers(strings_t& block);
+		void	_parseCpuAffinity(strings_t& block);
+		void	_parseFileCacheSize(strings_t& block);
+		void	_parseGzipCacheSize(strings_t& block);
+		void	_parseOpenFileCache(strings_t& block);
+		void	_parseOpenFileCacheValid(strings_t& block);
+};
@@ -1,42 +1,61 @@
-#pragma once
-#include <string>
-#include <vector>
-#include <cstdint>
-
-#include "Exceptions.hpp"
-
-#define DEF_PORT "8080"
-#define DEF_HOST "127.0.0.1"
-#define MAX_PORT 65535
-
-typedef std::vector<std::string> strings_t;
-
-class Listen
-{
-	public:
-		Listen(const Listen& copy);
-		Listen&	operator=(const Listen& assign);
-		Listen(void);
-		virtual ~Listen(void);
-
-		void						fillValues(strings_t& block);
-		void						setDef(bool);
-		const std::string&			getIpString(void) const;
-		const std::vector<uint8_t>&	getIpInt(void) const;
-		const std::string&			getPortString(void) const;
-		const uint16_t&				getPortInt(void) const;
-		const bool&					getDef(void) const;
-		bool						operator==(const Listen&) const;
-		bool						operator!=(const Listen&) const;
-
-	private:
-		uint16_t				i_port;	// Port val;
-		std::vector<uint8_t>	i_ip;	// Ip vals
-		std::string				s_ip;	// String ip
-		std::string				s_port;	// String port
-		bool					def;	// Check for default_server
-
-		void	_fillFull(strings_t& block);
-		void	_fillIp(strings_t& block);
-		void	_fillPort(strings_t& block);
-};
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+
+#include "Exceptions.hpp"
+
+#define DEF_PORT "8080"
+#define DEF_HOST "127.0.0.1"
+#define MAX_PORT 65535
+#define DEF_BACKLOG 511			// same as nginx, the kernel caps it to somaxconn
+#define DEF_DEFER_ACCEPT 1		// seconds the kernel waits for data before handing out a silent connection
+#define MAX_SOCK_BUF (64 * 1024 * 1024)
+
+typedef std::vector<std::string> strings_t;
+
+class Listen
+{
+	public:
+		Listen(const Listen& copy);
+		Listen&	operator=(const Listen& assign);
+		Listen(void);
+		virtual ~Listen(void);
+
+		void						fillValues(strings_t& block);
+		void						fillOptions(strings_t& block);
+		void						setDef(bool);
+		const std::string&			getIpString(void) const;
+		const std::vector<uint8_t>&	getIpInt(void) const;
+		const std::string&			getPortString(void) const;
+		const uint16_t&				getPortInt(void) const;
+		const bool&					getDef(void) const;
+		int							getBacklog(void) const;
+		int							getDeferAccept(void) const;
+		int							getFastOpen(void) const;
+		int							getRcvBuf(void) const;
+		int							getSndBuf(void) const;
+		bool						getNoDelay(void) const;
+		bool						operator==(const Listen&) const;
+		bool						operator!=(const Listen&) const;
+
+	private:
+		uint16_t				i_port;	// Port val;
+		std::vector<uint8_t>	i_ip;	// Ip vals
+		std::string				s_ip;	// String ip
+		std::string				s_port;	// String port
+		bool					def;	// Check for default_server
+		int						backlog;		// listen() queue length
+		int						deferAccept;	// TCP_DEFER_ACCEPT seconds, 0 = off
+		int						fastOpen;		// TCP_FASTOPEN queue length, 0 = off
+		int						rcvBuf;			// SO_RCVBUF, 0 = system default
+		int						sndBuf;			// SO_SNDBUF, 0 = system default
+		bool					noDelay;		// TCP_NODELAY, inherited by accepted sockets
+
+		void	_fillFull(strings_t& block);
+		void	_fillIp(strings_t& block);
+		void	_fillPort(strings_t& block);
+		int		_parseOptionValue(const std::string& option, bool isSize) const;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+
+#include "Exceptions.hpp"
+#include "HTTPstruct.hpp"
+
+typedef std::vector<std::string> strings_t;
+
+#define MIME_EXT_MAX 16			// longer extensions are refused and never looked up
+#define MIME_TABLE_MIN 16		// slots of the smallest table, always a power of two
+#define MIME_BUCKET_LOAD 2		// slots per bucket of the first level hash
+#define MIME_SEED_TRIES 4096	// seeds tried on a bucket before the table grows
+#define DEF_DEFAULT_TYPE "text/plain"
+#define DEF_MIME_TYPES {{"html", "text/html"}, {"htm", "text/html"}, {"css", "text/css"}, {"js", "text/javascript"}, \
+	{"txt", "text/plain"}, {"jpg", "image/jpeg"}, {"jpeg", "image/jpeg"}, {"png", "image/png"}, {"ico", "image/vnd.microsoft.icon"}}
+#define CHARSET_TYPES {"application/javascript", "application/json", "application/xml"}	// besides text/*
+
+// media type of an extension with its header line, rendered once
+typedef struct MimeType
+{
+	std::string	type;
+	std::string	line;		// "Content-Type: type\r\n"
+}	t_MimeType;
+
+// extension -> media type registry filled by the 'types' blocks, compiled at startup into a
+// perfect hash table (hash and displace): a lookup is one probe and one comparison.
+// Read only once compiled, the workers share it
+class MimeTypes
+{
+	public:
+		MimeTypes(void);
+		MimeTypes(const MimeTypes& copy);
+		MimeTypes&	operator=(const MimeTypes& assign);
+		virtual ~MimeTypes(void);
+
+		void				parseBlock(strings_t& block);
+		void				compile(void);
+		const t_MimeType*	find(std::string_view extension) const noexcept;
+		static t_MimeType	render(std::string const& type);
+		static bool			takesCharset(std::string_view type) noexcept;
+		static const MimeTypes&	builtin(void);
+
+	private:
+		typedef std::unordered_map<std::string, std::string>	types_t;
+		typedef struct Slot
+		{
+			std::string	extension;	// empty: free
+			t_MimeType	mime;
+		}	t_Slot;
+
+		std::vector<std::pair<std::string, std::string>>	declared; // extension and type, in declaration order
+		std::vector<t_Slot>		slots; // power of two
+		std::vector<uint32_t>	seeds; // second level seed of each bucket
+
+		void			_parseType(strings_t& block);
+		bool			_place(types_t const& types, size_t size);
+		bool			_fitBucket(std::vector<types_t::value_type const*> const& bucket, uint32_t seed, std::vector<size_t>& picked) const;
+		static uint64_t	_hash(std::string_view key, uint32_t seed) noexcept;
+};
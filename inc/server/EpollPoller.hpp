@@ -0,0 +1,32 @@
+#pragma once
+#ifdef __linux__
+#include <sys/epoll.h>		// epoll_create1, epoll_ctl, epoll_wait
+#include <unistd.h>			// close
+#include <unordered_map>
+#include <cstring>			// strerror
+#include <cerrno>			// errno
+
+#include "Poller.hpp"
+
+class EpollPoller : public Poller
+{
+	public:
+		EpollPoller( void );
+		virtual ~EpollPoller( void ) override;
+
+		void		addFd( int, short ) override;
+		void		modFd( int, short ) override;
+		void		delFd( int ) noexcept override;
+		void		wait( std::vector<struct pollfd>&, int ) override;
+		std::string	getName( void ) const noexcept override;
+
+	private:
+		int									_epollFd;
+		std::vector<struct epoll_event>		_events;
+		std::unordered_map<int, short>		_alwaysReady;	// regular files can't be added to epoll, they're always ready (as with poll)
+
+		uint32_t	_toEpoll( short ) const noexcept;
+		short		_fromEpoll( uint32_t ) const noexcept;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+#include <unordered_map>
+#include <cerrno>			// errno
+
+#include "Poller.hpp"
+
+// fallback backend for systems without epoll
+class PollPoller : public Poller
+{
+	public:
+		PollPoller( void ) {};
+		virtual ~PollPoller( void ) override {};
+
+		void		addFd( int, short ) override;
+		void		modFd( int, short ) override;
+		void		delFd( int ) noexcept override;
+		void		wait( std::vector<struct pollfd>&, int ) override;
+		std::string	getName( void ) const noexcept override;
+
+	private:
+		std::vector<struct pollfd>		_pollfds;
+		std::unordered_map<int, size_t>	_indexes;	// fd -> position inside _pollfds
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <sys/poll.h>		// struct pollfd, POLLIN, POLLOUT
+#include <vector>
+#include <iostream>
+#include <string>
+
+#include "Exceptions.hpp"
+#include "Events.hpp"
+
+#define POLLER_MAX_EVENTS	1024	// max events returned by a single wait
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+# define WEBSERV_HAS_IO_URING
+#endif
+
+// readiness notification backend: every fd is registered once and its interest
+// (POLLIN / POLLOUT / none) is only updated when the state of the fd changes;
+// HUP and ERR conditions are always reported, as poll() does
+class Poller
+{
+	public:
+		virtual ~Poller( void ) {};
+
+		virtual void		addFd( int, short ) =0;
+		virtual void		modFd( int, short ) =0;
+		virtual void		delFd( int ) noexcept =0;
+		virtual void		wait( std::vector<struct pollfd>&, int ) =0;
+		virtual std::string	getName( void ) const noexcept =0;
+
+		static Poller*		create( PollerEngine );
+};
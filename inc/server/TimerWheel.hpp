@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std::chrono;
+
+#define TIMER_TICK_MS		10		// resolution of the wheel
+#define TIMER_LEVELS		4		// 64^4 ticks = ~46 hours with 10 ms ticks
+#define TIMER_SLOT_BITS		6
+#define TIMER_SLOTS			(1 << TIMER_SLOT_BITS)
+
+typedef enum TimerType_s
+{
+	TIMER_HEADER,		// whole request head must arrive within it
+	TIMER_BODY,			// between two reads of the request body
+	TIMER_KEEPALIVE,	// idle connection between two requests
+	TIMER_SEND,			// between two writes to the client
+	TIMER_CGI,			// execution of the CGI script
+}	TimerType;
+
+// intrusive node, lives inside the struct owning the timer
+typedef struct Timer
+{
+	int				fd;
+	TimerType		type;
+	uint64_t		expiry;				// in ticks
+	uint8_t			level, slot;
+	struct Timer	*prev, *next;		// next == nullptr: not armed
+} t_Timer;
+
+// hierarchical timing wheel: arm, cancel and expire are O(1); every level
+// keeps a bitmap of its non-empty slots so the next wake up is found in
+// O(TIMER_LEVELS) as well
+class TimerWheel
+{
+	public:
+		TimerWheel( void );
+		~TimerWheel( void ) {};
+
+		void		arm( t_Timer&, milliseconds );
+		void		cancel( t_Timer& ) noexcept;
+		void		advance( void ) noexcept;
+		t_Timer*	popExpired( void ) noexcept;
+		int			msUntilNext( void ) const noexcept;
+
+	private:
+		steady_clock::time_point	_start;
+		uint64_t					_currentTick;
+		size_t						_pending;			// armed timers not expired yet
+		t_Timer						_slots[TIMER_LEVELS][TIMER_SLOTS];	// sentinels of circular lists
+		uint64_t					_occupied[TIMER_LEVELS];
+		t_Timer						_expired;
+
+		uint64_t	_nowTick( void ) const noexcept;
+		void		_place( t_Timer& ) noexcept;
+		void		_link( t_Timer&, t_Timer& ) noexcept;
+		void		_cascade( int, int ) noexcept;
+};
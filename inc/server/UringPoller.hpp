@@ -0,0 +1,63 @@
+#pragma once
+#include "Poller.hpp"
+#ifdef WEBSERV_HAS_IO_URING
+#include <linux/io_uring.h>	// io_uring_params, io_uring_sqe, io_uring_cqe
+#include <sys/syscall.h>	// __NR_io_uring_setup, __NR_io_uring_enter
+#include <sys/mman.h>		// mmap, munmap
+#include <unistd.h>			// syscall, close
+#include <unordered_map>
+#include <cstring>			// strerror, memset
+#include <cerrno>			// errno
+#include <ctime>			// struct timespec
+
+#define URING_ENTRIES		4096			// submission queue size
+#define URING_REMOVE_TAG	UINT64_MAX		// user_data of the poll removals, their completions are ignored
+
+// io_uring backend: interest changes and re-arms are queued as SQEs and
+// submitted together with the wait, so one loop iteration costs a single
+// io_uring_enter no matter how many fds changed state. Polls are one-shot and
+// re-armed after they fire, which keeps the level-triggered behaviour the
+// state machine relies on
+class UringPoller : public Poller
+{
+	public:
+		UringPoller( void );
+		virtual ~UringPoller( void ) override;
+
+		void		addFd( int, short ) override;
+		void		modFd( int, short ) override;
+		void		delFd( int ) noexcept override;
+		void		wait( std::vector<struct pollfd>&, int ) override;
+		std::string	getName( void ) const noexcept override;
+
+	private:
+		typedef struct UringItem
+		{
+			short		events;
+			uint32_t	gen;		// changes at every arm, completions of older arms are stale
+			bool		armed;
+			bool		queued;		// waiting in _toArm
+		} t_UringItem;
+
+		int						_ringFd;
+		void					*_ring;
+		size_t					_ringSize;
+		struct io_uring_sqe		*_sqes;
+		size_t					_sqesSize;
+		unsigned				*_sqHead, *_sqTail, *_sqMask, *_sqArray, _sqEntries, _sqLocalTail;
+		unsigned				*_cqHead, *_cqTail, *_cqMask;
+		struct io_uring_cqe		*_cqes;
+		uint32_t				_nextGen;
+
+		std::unordered_map<int, t_UringItem>	_items;
+		std::vector<int>						_toArm;
+
+		struct io_uring_sqe*	_getSqe( void );
+		void					_armPoll( int, t_UringItem& );
+		void					_removePoll( int, t_UringItem const& ) noexcept;
+		void					_queueArm( int, t_UringItem& ) noexcept;
+		void					_handleCqe( struct io_uring_cqe const&, std::vector<struct pollfd>& );
+		int						_enter( unsigned, unsigned, unsigned, void*, size_t ) noexcept;
+		void					_unmap( void ) noexcept;
+};
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 #include <unordered_map>
 #include <netinet/in.h>     // socket, accept, listen, bind, connect
+#include <netinet/tcp.h>    // TCP_NODELAY, TCP_DEFER_ACCEPT, TCP_FASTOPEN
 #include <arpa/inet.h>      // htons, htonl, ntohs, ntohl
 #include <sys/poll.h>     	// poll
 #include <algorithm>
@@ -9,21 +10,28 @@
 #include <fstream>			// file streaming
 #include <netdb.h>          // gai_strerror, getaddrinfo, freeaddrinfo
 #include <cerrno>           // errno
+#include <cstring>          // strerror
 #include <string>			// std::string class
 #include <vector>
-#include <chrono>			// timeout handling
 
 #include "HTTPresponse.hpp"
 #include "HTTPrequest.hpp"
 #include "Exceptions.hpp"
 #include "Config.hpp"
+#include "Events.hpp"
 #include "CGI.hpp"
+#include "Poller.hpp"
+#include "TimerWheel.hpp"
 
-#define BACKLOG 			10		// max pending connection queued up
+#define ACCEPT_BATCH		64		// max connections accepted per listener event, keeps the loop fair
 #define SERVER_DEF_PAGES	path_t("default/errors")
-#define CONN_MAX_TIMEOUT	7
-
-using namespace std::chrono;
+#define CONN_MAX_TIMEOUT	7		// keep-alive: idle seconds between two requests
+#define HEADER_TIMEOUT		10		// seconds to receive the whole request head
+#define BODY_TIMEOUT		10		// seconds between two reads of the request body
+#define SEND_TIMEOUT		10		// seconds between two writes to the client
+#define CGI_TIMEOUT			30		// seconds for the CGI to complete
+#define SLAB_CHUNK_BITS		10
+#define SLAB_CHUNK_SIZE		(1 << SLAB_CHUNK_BITS)	// connection table grows by chunks of 1024 fds
 
 enum fdType
 {
@@ -31,50 +39,69 @@ enum fdType
     CLIENT_CONNECTION,			// fd linked to socket connection
     CGI_REQUEST_PIPE_WRITE_END,	// fd of pipe to write req. body to CGI
     CGI_RESPONSE_PIPE_READ_END,	// fd of pipe to write CGI response into HTTP response
-    STATIC_FILE					// fd of a static file (GET reqs)
+    STATIC_FILE					// fd of a static file that is not a regular file (GET reqs)
 };
 
 enum fdState
 {
 	WAITING_FOR_CONNECTION,	// LISTENER (read)
 	READ_REQ_HEADER,		// CLIENT_CONNECTION (read)
-	READ_STATIC_FILE,		// STATIC_FILE (read)
+	READ_STATIC_FILE,		// STATIC_FILE (read), fills the response buffer
 	READ_REQ_BODY,			// CLIENT_CONNECTION (read)
+	WAIT_FOR_CGI_INPUT,		// CLIENT_CONNECTION (no action), body buffer full until the CGI reads
 	WAIT_FOR_CGI,			// CLIENT_CONNECTION (no action)
-	READ_CGI_RESPONSE,		// CGI_RESPONSE_PIPE (read)
+	READ_CGI_RESPONSE,		// CGI_RESPONSE_PIPE (read), fills the response buffer
 	WRITE_TO_CLIENT,		// CLIENT_CONNECTION (write)
-	WRITE_TO_CGI			// CGI_REQUEST_PIPE (write)
+	WAIT_FOR_RESP_BODY,		// CLIENT_CONNECTION (no action), response buffer empty until its source produces more
+	WRITE_TO_CGI,			// CGI_REQUEST_PIPE (write)
+	WAIT_FOR_REQ_BODY,		// CGI_REQUEST_PIPE (no action), body buffer empty until the client sends more
+	WAIT_FOR_RESP_SPACE		// STATIC_FILE, CGI_RESPONSE_PIPE (out of the poller), response buffer full until the client drains it
 };
 
+// slot of the connection table, indexed by fd
 typedef struct PollItem
 {
+	bool						active;
+	bool						dropping;		// already queued in _emptyConns
 	fdType  					pollType;
     fdState 					pollState;
 	std::string					servIP;
 	std::string					servPort;
 	std::string					cliIP;
 	std::string					cliPort;
-	steady_clock::time_point	lastActivity;
+	int							owner;			// client connection served by this fd, itself for sockets
+	t_Timer						timer;
+	HTTPrequest					*request;		// CLIENT_CONNECTION only
+	HTTPresponse				*response;		// CLIENT_CONNECTION only
+	CGI							*cgi;			// CLIENT_CONNECTION only
+	std::string					pending;		// CLIENT_CONNECTION only, bytes of the next pipelined request
 } t_PollItem;
 
 class WebServer
 {
 	public:
-		WebServer ( t_serv_list const& );
+		WebServer ( t_serv_list const&, Events const&, MimeTypes const& );
 		~WebServer ( void ) noexcept;
 
 		void	run( void );
 
 	private:
-		t_serv_list	 							_servers;
-		std::vector<struct pollfd>	 			_pollfds;
-		std::unordered_map<int, t_PollItem*>	_pollitems;
-		std::unordered_map<int, HTTPrequest*> 	_requests;
-		std::unordered_map<int, HTTPresponse*> 	_responses;
-		std::unordered_map<int, CGI*> 			_cgi;
+		t_serv_list const&						_servers;
+		MimeTypes const&						_mimeTypes;		// compiled once, shared by the workers
+		bool									_reusePort;
+		Poller									*_poller;
+		std::vector<struct pollfd>	 			_readyFds;
+		TimerWheel								_timers;
+		std::vector<t_PollItem*>				_slab;			// chunks of SLAB_CHUNK_SIZE slots, slot = fd
+		size_t									_nPollItems;
 		std::vector<int>						_emptyConns;
+		std::unordered_map<std::string, t_serv_list>	_listenerServers;	// ip:port -> servers listening on it
+		FileCache								_fileCache;		// small static files of this worker
+		OpenFileCache							_openFiles;		// stat results and fds of this worker
+		GzipCache								_gzipCache;		// compressed static files of this worker
 
-		void		_listenTo( std::string const&, std::string const& );
+		void		_listenTo( Listen const& );
+		void		_setListenOptions( int, Listen const& ) const;
 		void		_readData( int );
 		void		_writeData( int );
 		void		_addConn( int , 
@@ -84,21 +111,31 @@ class WebServer
 							std::string const& servPort="", 
 							std::string const& cliIP="", 
 							std::string const& cliPort="" );
+		void		_addAuxConn( int, fdType, fdState, int );
+		t_PollItem*	_getPollItem( int ) const;
+		void		_setState( int, fdState );
+		short		_getInterest( fdType, fdState ) const noexcept;
 		void		_dropConn( int ) noexcept;
 		void		_clearEmptyConns( void ) noexcept;
+		void		_dropAuxConns( int ) noexcept;
 		void		_clearStructs( int ) noexcept;
 		int			_getSocketFromFd( int );
-		t_serv_list	_getServersFromIP( std::string const&, std::string const& ) const noexcept;
+		t_serv_list const&	_getServersFromIP( std::string const&, std::string const& ) const;
 		path_t		_getDefErrorPage( int ) const ;
 
-		void	_resetTimeout( int );
-		void	_checkTimeout( int );
+		void	_armTimer( int, TimerType );
+		void	_armStateTimer( int );
+		void	_handleTimeout( t_Timer const& ) noexcept;
 
 		void	_handleNewConnection( int );
 		void	_readRequestHead( int );
 		void	_readStaticFile( int );
 		void	_readRequestBody( int );
+		void	_runCGI( int );
 		void	_readCGIresponse( int );
+		void	_updateBodySource( int, int );
+		void	_resumeBodySource( int );
+		void	_waitForCGI( int );
 		void	_writeToCGI( int );
 		void	_writeToClient( int );
 		void	_redirectToErrorPage( int, int ) noexcept;
@@ -8,14 +8,25 @@
 CGI::CGI(const HTTPrequest &req)
 	: _req(req),
 	  _CGIEnvArr(this->_createCgiEnv(req)),
-	  _CgiEnvCStyle(this->_createCgiEnvCStyle())
+	  _CgiEnvCStyle(this->_createCgiEnvCStyle()),
+	  _pid(-1),
+	  _reaped(false)
 {
-	pipe(_uploadPipe);
-	pipe(_responsePipe);
+	if (req.isBodySpilled() == true)		// the body file becomes stdin, no upload pipe needed
+		_uploadPipe[0] = _uploadPipe[1] = -1;
+	else
+	{
+		pipe2(_uploadPipe, O_CLOEXEC);		// CGIs forked by other requests (or workers) must not inherit these
+		fcntl(_uploadPipe[1], F_SETFL, O_NONBLOCK);		// a full pipe must not block the event loop, the CGI still reads blocking
+	}
+	pipe2(_responsePipe, O_CLOEXEC);
+	fcntl(_responsePipe[0], F_SETFL, O_NONBLOCK);		// the output is streamed, read until the pipe is empty
 }
 
 CGI::~CGI() {
 	delete[] this->_CgiEnvCStyle;
+	if ((this->_pid > 0) and (this->_reaped == false) and (waitpid(this->_pid, nullptr, WNOHANG) == 0))		// response sent before the CGI exited
+		killCGIproc();
 }
 
 std::array<std::string, CGI_ENV_SIZE> CGI::_createCgiEnv(const HTTPrequest &req)
@@ -60,23 +71,28 @@ char **CGI::_createCgiEnvCStyle(void)
 
 void CGI::run()
 {
+	// everything is prepared before forking: with several workers the child must not allocate
+	std::string CGIfilePath = _req.getRealPath().string();
+	std::string CGIfileName = _req.getRealPath().filename().string(); // fully stripped, only used for execve
+	std::string errorMsg = "Error in running CGI script!\npath: " + CGIfilePath + "\n";
+	char *argv[2] = {(char*)CGIfileName.c_str(), NULL};
+	int stdinFd = this->_uploadPipe[0];
+
+	if (this->_req.isBodySpilled() == true)
+	{
+		stdinFd = this->_req.getBodyFd();
+		lseek(stdinFd, 0, SEEK_SET);		// the offset is shared with the child
+	}
 	this->_pid = fork();
 	if (this->_pid == 0) {
-		std::string CGIfilePath = _req.getRealPath().string();
-		std::string CGIfileName = _req.getRealPath().filename().string(); // fully stripped, only used for execve
-		close(this->_responsePipe[0]);
 		dup2(this->_responsePipe[1], STDOUT_FILENO); // write to pipe
-		close(this->_uploadPipe[1]);
-		dup2(this->_uploadPipe[0], STDIN_FILENO); // read from pipe
-		char *argv[2] = {(char*)CGIfileName.c_str(), NULL};
+		dup2(stdinFd, STDIN_FILENO); // read from pipe or body file
 		int res = execve(CGIfilePath.c_str(), argv, this->_CgiEnvCStyle);
 		if (res != 0)
 		{
-			close(this->_responsePipe[1]);
-			std::cerr << "Error in running CGI script!" << std::endl;
-			std::cerr << "path: " << CGIfilePath.c_str() << std::endl;
+			write(STDERR_FILENO, errorMsg.c_str(), errorMsg.size());
 			perror("");
-			exit(EXIT_FAILURE);
+			_exit(EXIT_FAILURE);
 		}
 	}
 	else {
@@ -87,19 +103,42 @@ void CGI::run()
 bool	CGI::waitCGIproc() const 
 {
 	int cgiExitCode = -1;
-	int waitStatus = waitpid(this->_pid, &cgiExitCode, WNOHANG);
+	int waitStatus = -1;
+
+	if (this->_reaped == true)
+		return (true);
+	waitStatus = waitpid(this->_pid, &cgiExitCode, WNOHANG);
 	if (waitStatus == -1)
 		throw(CGIexception({"error while waiting CGI process, pid", std::to_string(this->_pid)}, 500));
 	else if (waitStatus == 0)		// if it's 0 the child is not done yet
 		return (false);
 	else
 	{
+		this->_reaped = true;
 		if (cgiExitCode != EXIT_SUCCESS)
 			throw(CGIexception({"error while running CGI"}, 500));
 		return (true);
 	}
 }
 
+void	CGI::killCGIproc() const
+{
+	if (this->_reaped == true)		// the pid may belong to another process by now
+		return ;
+	if (kill(this->_pid, SIGKILL) == 0)
+		waitpid(this->_pid, nullptr, 0);
+	this->_reaped = true;
+}
+
+// the parent only writes to the upload pipe, the read end is closed once
+void	CGI::closeUploadReadEnd()
+{
+	if (this->_uploadPipe[0] == -1)
+		return ;
+	close(this->_uploadPipe[0]);
+	this->_uploadPipe[0] = -1;
+}
+
 int CGI::getRequestSocket() const {
 	return this->_req.getSocket();
 }
@@ -112,10 +151,3 @@ const std::array<int, 2> CGI::getResponsePipe() const {
 	return std::array<int, 2> {this->_responsePipe[0], this->_responsePipe[1]};
 }
 
-std::string CGI::getResponse() const {
-	return this->_response;
-}
-
-void CGI::appendResponse(std::string additionalResponsePart) {
-	this->_response = this->_response + additionalResponsePart;
-}
@@ -0,0 +1,55 @@
+#include "BodySource.hpp"
+
+// copies up to length bytes into a new block of the chain, returns the bytes added
+size_t	BodySource::readInto( BufferChain& chain, size_t length )
+{
+	std::string	block(length, '\0');
+	size_t		filled = 0;
+	ssize_t		readChars = 0;
+
+	while (filled < length)
+	{
+		readChars = read(block.data() + filled, length - filled);
+		if (readChars <= 0)
+			break ;
+		filled += readChars;
+	}
+	block.resize(filled);
+	if (filled < length / 2)		// a short read shouldn't pin the whole allocation while queued
+		block.shrink_to_fit();
+	chain.append(std::move(block));
+	return (filled);
+}
+
+ssize_t	BodySource::sendTo( int socket, size_t length )
+{
+	(void) socket;
+	(void) length;
+	throw(ServerException({"body source can't be sent without copying"}));
+}
+
+// a direct source skips the response buffer, its bytes go to the socket with sendTo
+bool	BodySource::isDirect( void ) const noexcept
+{
+	return (false);
+}
+
+// fd to poll before read produces more, -1 when read never has to wait
+int		BodySource::getFd( void ) const noexcept
+{
+	return (-1);
+}
+
+// new source over a byte range of what is left, nullptr when the source can't seek
+BodySource*	BodySource::slice( off_t offset, off_t length ) const
+{
+	(void) offset;
+	(void) length;
+	return (nullptr);
+}
+
+// total bytes, -1 when only known once the source is done
+off_t	BodySource::getLength( void ) const noexcept
+{
+	return (-1);
+}
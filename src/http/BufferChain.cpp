@@ -0,0 +1,95 @@
+#include "BufferChain.hpp"
+
+// takes the bytes over without copying them
+void	BufferChain::append( std::string&& bytes )
+{
+	if (bytes.empty() == true)
+		return ;
+	append(std::make_shared<std::string const>(std::move(bytes)));
+}
+
+// shares a slice of the block, it lives as long as one segment refers to it
+void	BufferChain::append( block_t const& block, size_t offset, size_t length )
+{
+	if ((block == nullptr) or (offset >= block->size()))
+		return ;
+	length = std::min(length, block->size() - offset);
+	if (length == 0)
+		return ;
+	this->_segments.push_back({block, offset, length});
+	this->_size += length;
+}
+
+// moves the segments of the other chain to the end of this one
+void	BufferChain::append( BufferChain&& other )
+{
+	for (t_Segment& segment : other._segments)
+		this->_segments.push_back(std::move(segment));
+	this->_size += other._size;
+	other.clear();
+}
+
+// gathers the first segments in one call, sendmsg when flags are given (sockets only)
+// returns 0 when fd can't take anything now and -1 on error
+ssize_t	BufferChain::writeTo( int fd, int flags ) noexcept
+{
+	struct iovec	parts[CHAIN_IOV_MAX];
+	struct msghdr	message = {};
+	size_t			count = 0;
+	ssize_t			written = -1;
+
+	if (this->_size == 0)
+		return (0);
+	for (auto it = this->_segments.begin(); (it != this->_segments.end()) and (count < CHAIN_IOV_MAX); ++it, ++count)
+	{
+		parts[count].iov_base = const_cast<char*>(it->block->data() + it->offset);
+		parts[count].iov_len = it->length;
+	}
+	if (flags == 0)
+		written = writev(fd, parts, count);
+	else
+	{
+		message.msg_iov = parts;
+		message.msg_iovlen = count;
+		written = sendmsg(fd, &message, flags);
+	}
+	if (written < 0)
+		return (((errno == EAGAIN) or (errno == EWOULDBLOCK)) ? 0 : -1);
+	_consume(written);
+	return (written);
+}
+
+void	BufferChain::clear( void ) noexcept
+{
+	this->_segments.clear();
+	this->_size = 0;
+}
+
+size_t	BufferChain::size( void ) const noexcept
+{
+	return (this->_size);
+}
+
+bool	BufferChain::empty( void ) const noexcept
+{
+	return (this->_size == 0);
+}
+
+// drops the written segments, a partly written one only moves its offset
+void	BufferChain::_consume( size_t length ) noexcept
+{
+	this->_size -= length;
+	while (length > 0)
+	{
+		t_Segment&	front = this->_segments.front();
+
+		if (length < front.length)
+		{
+			front.offset += length;
+			front.length -= length;
+			return ;
+		}
+		length -= front.length;
+		this->_segments.pop_front();
+	}
+}
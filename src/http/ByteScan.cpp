@@ -0,0 +1,173 @@
+#include "ByteScan.hpp"
+
+#ifdef BYTESCAN_X86
+ByteScan::t_findByte	ByteScan::_findByte = ByteScan::_hasAVX2() ? ByteScan::_findByteAVX2 : ByteScan::_findByteSSE2;
+ByteScan::t_findSeq		ByteScan::_findSeq = ByteScan::_hasAVX2() ? ByteScan::_findSeqAVX2 : ByteScan::_findSeqSSE2;
+char const*				ByteScan::_engineName = ByteScan::_hasAVX2() ? "avx2" : "sse2";
+#else
+ByteScan::t_findByte	ByteScan::_findByte = ByteScan::_findByteScalar;
+ByteScan::t_findSeq		ByteScan::_findSeq = ByteScan::_findSeqScalar;
+char const*				ByteScan::_engineName = "scalar";
+#endif
+
+char const*	ByteScan::find( char const* buffer, size_t length, char byte ) noexcept
+{
+	return (_findByte(buffer, length, byte));
+}
+
+char const*	ByteScan::find( char const* buffer, size_t length, std::string_view needle ) noexcept
+{
+	if (needle.empty() == true)
+		return (buffer);
+	if (needle.size() > length)
+		return (nullptr);
+	if (needle.size() == 1)
+		return (_findByte(buffer, length, needle.front()));
+	return (_findSeq(buffer, length, needle));
+}
+
+size_t	ByteScan::find( std::string_view haystack, char byte, size_t pos ) noexcept
+{
+	char const	*found = nullptr;
+
+	if (pos >= haystack.size())
+		return (std::string_view::npos);
+	found = find(haystack.data() + pos, haystack.size() - pos, byte);
+	return ((found == nullptr) ? std::string_view::npos : static_cast<size_t>(found - haystack.data()));
+}
+
+size_t	ByteScan::find( std::string_view haystack, std::string_view needle, size_t pos ) noexcept
+{
+	char const	*found = nullptr;
+
+	if (pos > haystack.size())
+		return (std::string_view::npos);
+	found = find(haystack.data() + pos, haystack.size() - pos, needle);
+	return ((found == nullptr) ? std::string_view::npos : static_cast<size_t>(found - haystack.data()));
+}
+
+char const*	ByteScan::getEngineName( void ) noexcept
+{
+	return (_engineName);
+}
+
+bool	ByteScan::_hasAVX2( void ) noexcept
+{
+#ifdef BYTESCAN_X86
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("avx2"));
+#else
+	return (false);
+#endif
+}
+
+char const*	ByteScan::_findByteScalar( char const* buffer, size_t length, char byte ) noexcept
+{
+	return (static_cast<char const*>(memchr(buffer, byte, length)));
+}
+
+char const*	ByteScan::_findSeqScalar( char const* buffer, size_t length, std::string_view needle ) noexcept
+{
+	char const	*end = nullptr;
+	char const	*candidate = buffer;
+
+	if (needle.size() > length)
+		return (nullptr);
+	end = buffer + length - needle.size() + 1;		// last possible start + 1
+	while ((candidate = static_cast<char const*>(memchr(candidate, needle.front(), end - candidate))) != nullptr)
+	{
+		if (memcmp(candidate + 1, needle.data() + 1, needle.size() - 1) == 0)
+			return (candidate);
+		candidate++;
+	}
+	return (nullptr);
+}
+
+#ifdef BYTESCAN_X86
+
+// 16 bytes per compare, SSE2 is part of every x86-64 cpu
+char const*	ByteScan::_findByteSSE2( char const* buffer, size_t length, char byte ) noexcept
+{
+	__m128i const	pattern = _mm_set1_epi8(byte);
+	size_t			pos = 0;
+	int				mask = 0;
+
+	for (; pos + 16 <= length; pos += 16)
+	{
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(buffer + pos)), pattern));
+		if (mask != 0)
+			return (buffer + pos + __builtin_ctz(mask));
+	}
+	return (_findByteScalar(buffer + pos, length - pos, byte));
+}
+
+// compares the first and the last byte of the needle at 16 offsets at once, only full candidates reach memcmp
+char const*	ByteScan::_findSeqSSE2( char const* buffer, size_t length, std::string_view needle ) noexcept
+{
+	__m128i const	first = _mm_set1_epi8(needle.front());
+	__m128i const	last = _mm_set1_epi8(needle.back());
+	size_t const	lastOffset = needle.size() - 1;
+	size_t			pos = 0;
+	int				mask = 0;
+	char const		*found = nullptr;
+
+	for (; pos + lastOffset + 16 <= length; pos += 16)
+	{
+		mask = _mm_movemask_epi8(_mm_and_si128(
+			_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(buffer + pos)), first),
+			_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(buffer + pos + lastOffset)), last)));
+		while (mask != 0)
+		{
+			found = buffer + pos + __builtin_ctz(mask);
+			if (memcmp(found + 1, needle.data() + 1, lastOffset - 1) == 0)
+				return (found);
+			mask &= mask - 1;
+		}
+	}
+	return (_findSeqScalar(buffer + pos, length - pos, needle));
+}
+
+// same as the SSE2 versions with 32 bytes per compare
+__attribute__((target("avx2")))
+char const*	ByteScan::_findByteAVX2( char const* buffer, size_t length, char byte ) noexcept
+{
+	__m256i const	pattern = _mm256_set1_epi8(byte);
+	size_t			pos = 0;
+	unsigned int	mask = 0;
+
+	for (; pos + 32 <= length; pos += 32)
+	{
+		mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(buffer + pos)), pattern));
+		if (mask != 0)
+			return (buffer + pos + __builtin_ctz(mask));
+	}
+	return (_findByteSSE2(buffer + pos, length - pos, byte));
+}
+
+__attribute__((target("avx2")))
+char const*	ByteScan::_findSeqAVX2( char const* buffer, size_t length, std::string_view needle ) noexcept
+{
+	__m256i const	first = _mm256_set1_epi8(needle.front());
+	__m256i const	last = _mm256_set1_epi8(needle.back());
+	size_t const	lastOffset = needle.size() - 1;
+	size_t			pos = 0;
+	unsigned int	mask = 0;
+	char const		*found = nullptr;
+
+	for (; pos + lastOffset + 32 <= length; pos += 32)
+	{
+		mask = _mm256_movemask_epi8(_mm256_and_si256(
+			_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(buffer + pos)), first),
+			_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(buffer + pos + lastOffset)), last)));
+		while (mask != 0)
+		{
+			found = buffer + pos + __builtin_ctz(mask);
+			if (memcmp(found + 1, needle.data() + 1, lastOffset - 1) == 0)
+				return (found);
+			mask &= mask - 1;
+		}
+	}
+	return (_findSeqSSE2(buffer + pos, length - pos, needle));
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "ChunkedDecoder.hpp"
+
+ChunkedDecoder::ChunkedDecoder( void ) noexcept
+{
+	reset();
+}
+
+// appends the decoded bytes to body, returns how many input bytes belong to the chunked body
+size_t	ChunkedDecoder::decode( char const* input, size_t length, std::string& body )
+{
+	char const	*newLine = nullptr;
+	size_t		pos = 0, toCopy = 0;
+	int			digit = 0;
+
+	while ((this->_state != CHUNK_DONE) and (pos < length))
+	{
+		switch (this->_state)
+		{
+			case CHUNK_SIZE:
+				digit = _hexValue(input[pos]);
+				if (digit != -1)
+				{
+					if (this->_chunkSize > (std::numeric_limits<size_t>::max() >> 4))
+						throw(RequestException({"chunk size too big"}, 413));
+					this->_chunkSize = (this->_chunkSize << 4) | digit;
+					this->_sizeDigits++;
+				}
+				else if ((input[pos] == ';') or (input[pos] == ' ') or (input[pos] == '\t'))
+					this->_state = CHUNK_EXT;
+				else if (input[pos] == '\r')
+					this->_state = CHUNK_SIZE_LF;
+				else if (input[pos] == '\n')
+					_endSizeLine();
+				else
+					throw(RequestException({"bad chunking: invalid chunk size"}, 400));
+				pos++;
+				break;
+
+			case CHUNK_EXT:		// extensions are ignored
+				newLine = ByteScan::find(input + pos, length - pos, '\n');
+				if (newLine == nullptr)
+					return (length);
+				pos = newLine - input + 1;
+				_endSizeLine();
+				break;
+
+			case CHUNK_SIZE_LF:
+				if (input[pos++] != '\n')
+					throw(RequestException({"bad chunking: missing line feed"}, 400));
+				_endSizeLine();
+				break;
+
+			case CHUNK_DATA:
+				toCopy = std::min(this->_chunkSize, length - pos);
+				body.append(input + pos, toCopy);
+				pos += toCopy;
+				this->_chunkSize -= toCopy;
+				if (this->_chunkSize == 0)
+					this->_state = CHUNK_DATA_CR;
+				break;
+
+			case CHUNK_DATA_CR:
+				if (input[pos] == '\r')
+					this->_state = CHUNK_DATA_LF;
+				else if (input[pos] == '\n')
+					this->_state = CHUNK_SIZE;
+				else
+					throw(RequestException({"bad chunking: chunk longer than its size"}, 400));
+				pos++;
+				break;
+
+			case CHUNK_DATA_LF:
+				if (input[pos++] != '\n')
+					throw(RequestException({"bad chunking: missing line feed"}, 400));
+				this->_state = CHUNK_SIZE;
+				break;
+
+			case CHUNK_TRAILER:		// start of a trailer line, an empty one ends the body
+				if (input[pos] == '\r')
+					this->_state = CHUNK_TRAILER_LF;
+				else if (input[pos] == '\n')
+					this->_state = CHUNK_DONE;
+				else
+					this->_state = CHUNK_TRAILER_LINE;
+				pos++;
+				break;
+
+			case CHUNK_TRAILER_LINE:		// trailer fields are ignored
+				newLine = ByteScan::find(input + pos, length - pos, '\n');
+				if (newLine == nullptr)
+					return (length);
+				pos = newLine - input + 1;
+				this->_state = CHUNK_TRAILER;
+				break;
+
+			case CHUNK_TRAILER_LF:
+				if (input[pos++] != '\n')
+					throw(RequestException({"bad chunking: missing line feed"}, 400));
+				this->_state = CHUNK_DONE;
+				break;
+
+			default:
+				break;
+		}
+	}
+	return (pos);
+}
+
+void	ChunkedDecoder::reset( void ) noexcept
+{
+	this->_state = CHUNK_SIZE;
+	this->_chunkSize = 0;
+	this->_sizeDigits = 0;
+	this->_decodedSize = 0;
+	this->_maxSize = 0;
+}
+
+// 0 means no limit
+void	ChunkedDecoder::setMaxSize( size_t maxSize ) noexcept
+{
+	this->_maxSize = maxSize;
+}
+
+bool	ChunkedDecoder::isDone( void ) const noexcept
+{
+	return (this->_state == CHUNK_DONE);
+}
+
+size_t	ChunkedDecoder::getDecodedSize( void ) const noexcept
+{
+	return (this->_decodedSize);
+}
+
+void	ChunkedDecoder::_endSizeLine( void )
+{
+	if (this->_sizeDigits == 0)
+		throw(RequestException({"bad chunking: missing chunk size"}, 400));
+	this->_sizeDigits = 0;
+	if (this->_chunkSize == 0)
+	{
+		this->_state = CHUNK_TRAILER;
+		return ;
+	}
+	if ((this->_maxSize != 0) and (this->_chunkSize > this->_maxSize - std::min(this->_decodedSize, this->_maxSize)))
+		throw(RequestException({"content body is longer than the maximum allowed"}, 413));
+	this->_decodedSize += this->_chunkSize;
+	this->_state = CHUNK_DATA;
+}
+
+int	ChunkedDecoder::_hexValue( char c ) noexcept
+{
+	if ((c >= '0') and (c <= '9'))
+		return (c - '0');
+	if ((c >= 'a') and (c <= 'f'))
+		return (c - 'a' + 10);
+	if ((c >= 'A') and (c <= 'F'))
+		return (c - 'A' + 10);
+	return (-1);
+}
@@ -0,0 +1,95 @@
+#include "FileCache.hpp"
+
+// trusted for FILE_CACHE_VALID seconds, then checked against the file once; a changed file is dropped
+FileCache::entry_t	FileCache::find( path_t const& path )
+{
+	auto		it = this->_entries.find(path.string());
+	std::time_t	now = std::time(nullptr);
+	struct stat	fileStat;
+
+	if (it == this->_entries.end())
+		return (nullptr);
+	if (now - it->second.entry->checkedAt >= FILE_CACHE_VALID)
+	{
+		if ((stat(path.c_str(), &fileStat) == -1) or (_isSameFile(*it->second.entry, fileStat) == false))
+		{
+			_erase(it);
+			return (nullptr);
+		}
+		it->second.entry->checkedAt = now;
+	}
+	this->_lru.splice(this->_lru.begin(), this->_lru, it->second.lru);
+	return (it->second.entry);
+}
+
+// reads a small regular file in one go, nullptr when it doesn't fit or can't be read
+FileCache::entry_t	FileCache::load( path_t const& path, std::string const& contentType )
+{
+	std::shared_ptr<t_CachedFile>	entry;
+	std::string						bytes;
+	struct stat						fileStat;
+	int								fd = -1;
+	ssize_t							readChars = 0;
+	size_t							filled = 0;
+
+	if ((isEnabled() == false) or (stat(path.c_str(), &fileStat) == -1) or (S_ISREG(fileStat.st_mode) == false)
+		or (canHold(fileStat.st_size) == false))
+		return (nullptr);
+	fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return (nullptr);
+	bytes.resize(fileStat.st_size);
+	while ((filled < bytes.size()) and ((readChars = read(fd, bytes.data() + filled, bytes.size() - filled)) > 0))
+		filled += readChars;
+	close(fd);
+	if (filled != bytes.size())		// changed while being read, served from disk this time
+		return (nullptr);
+	entry = std::make_shared<t_CachedFile>();
+	entry->headers = HTTP_HEADER_CONT_LEN + std::string(": ") + std::to_string(bytes.size()) + HTTP_NL
+		+ HTTP_HEADER_CONT_TYPE + std::string(": ") + contentType + HTTP_NL;
+	entry->body = std::make_shared<std::string const>(std::move(bytes));
+	entry->device = fileStat.st_dev;
+	entry->inode = fileStat.st_ino;
+	entry->mtime = fileStat.st_mtim;
+	entry->size = fileStat.st_size;
+	entry->checkedAt = std::time(nullptr);
+	if (this->_entries.count(path.string()) != 0)
+		_erase(this->_entries.find(path.string()));
+	while ((this->_lru.empty() == false) and (this->_size + entry->size > this->_capacity))		// least recently used go first
+		_erase(this->_entries.find(this->_lru.back()));
+	this->_lru.push_front(path.string());
+	this->_entries[path.string()] = {entry, this->_lru.begin()};
+	this->_size += entry->size;
+	return (entry);
+}
+
+void	FileCache::forget( path_t const& path ) noexcept
+{
+	auto	it = this->_entries.find(path.string());
+
+	if (it != this->_entries.end())
+		_erase(it);
+}
+
+bool	FileCache::isEnabled( void ) const noexcept
+{
+	return (this->_capacity > 0);
+}
+
+bool	FileCache::canHold( off_t size ) const noexcept
+{
+	return (static_cast<size_t>(size) <= std::min<size_t>(FILE_CACHE_MAX_FILE, this->_capacity));
+}
+
+void	FileCache::_erase( std::unordered_map<std::string, t_Slot>::iterator it ) noexcept
+{
+	this->_size -= it->second.entry->size;
+	this->_lru.erase(it->second.lru);
+	this->_entries.erase(it);
+}
+
+bool	FileCache::_isSameFile( t_CachedFile const& entry, struct stat const& fileStat ) noexcept
+{
+	return ((entry.device == fileStat.st_dev) and (entry.inode == fileStat.st_ino) and (entry.size == fileStat.st_size)
+		and (entry.mtime.tv_sec == fileStat.st_mtim.tv_sec) and (entry.mtime.tv_nsec == fileStat.st_mtim.tv_nsec));
+}
@@ -0,0 +1,63 @@
+#include "FileSource.hpp"
+
+OpenFile::~OpenFile( void )
+{
+	close(this->_fd);
+}
+
+int		OpenFile::getFd( void ) const noexcept
+{
+	return (this->_fd);
+}
+
+ssize_t	FileSource::read( char* buffer, size_t length )
+{
+	ssize_t	readChars = pread(this->_file->getFd(), buffer, std::min<off_t>(length, this->_end - this->_offset), this->_offset);
+
+	if (readChars < 0)
+		throw(ResponseException({"file not available:", strerror(errno)}, 500));
+	else if ((readChars == 0) and (isDone() == false))		// file shrank since fstat
+		throw(ResponseException({"file truncated while sending"}, 500));
+	this->_offset += readChars;
+	return (readChars);
+}
+
+// the offset is kept between POLLOUT events, 0 when the socket can't take more now
+ssize_t	FileSource::sendTo( int socket, size_t length )
+{
+	ssize_t	writtenChars = -1;
+
+	if (isDone() == true)
+		return (0);
+	writtenChars = sendfile(socket, this->_file->getFd(), &this->_offset, std::min<off_t>(length, this->_end - this->_offset));
+	if (writtenChars < 0)
+	{
+		if ((errno == EAGAIN) or (errno == EWOULDBLOCK))
+			return (0);
+		throw(ServerException({"socket not available"}));
+	}
+	else if (writtenChars == 0)
+		throw(ResponseException({"file truncated while sending"}, 500));
+	return (writtenChars);
+}
+
+bool	FileSource::isDone( void ) const noexcept
+{
+	return (this->_offset == this->_end);
+}
+
+bool	FileSource::isDirect( void ) const noexcept
+{
+	return (true);
+}
+
+off_t	FileSource::getLength( void ) const noexcept
+{
+	return (this->_end - this->_offset);
+}
+
+// shares the fd, each slice keeps its own offset
+BodySource*	FileSource::slice( off_t offset, off_t length ) const
+{
+	return (new FileSource(this->_file, this->_offset + offset, length));
+}
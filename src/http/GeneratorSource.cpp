@@ -0,0 +1,22 @@
+#include "GeneratorSource.hpp"
+
+ssize_t	GeneratorSource::read( char* buffer, size_t length )
+{
+	size_t	toCopy = 0;
+
+	while ((this->_pos == this->_piece.size()) and (this->_done == false))
+	{
+		this->_piece.clear();
+		this->_pos = 0;
+		this->_done = (this->_generator(this->_piece) == false);
+	}
+	toCopy = std::min(length, this->_piece.size() - this->_pos);
+	memcpy(buffer, this->_piece.data() + this->_pos, toCopy);
+	this->_pos += toCopy;
+	return (toCopy);
+}
+
+bool	GeneratorSource::isDone( void ) const noexcept
+{
+	return (this->_done and (this->_pos == this->_piece.size()));
+}
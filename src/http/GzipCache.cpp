@@ -0,0 +1,42 @@
+#include "GzipCache.hpp"
+
+GzipCache::block_t	GzipCache::find( std::string const& key )
+{
+	auto	it = this->_entries.find(key);
+
+	if (it == this->_entries.end())
+		return (nullptr);
+	this->_lru.splice(this->_lru.begin(), this->_lru, it->second.lru);
+	return (it->second.body);
+}
+
+// an evicted variant stays alive for the responses still sending it
+void	GzipCache::store( std::string const& key, std::string&& body )
+{
+	if (canHold(body.size()) == false)
+		return ;
+	if (this->_entries.count(key) != 0)
+		_erase(this->_entries.find(key));
+	while ((this->_lru.empty() == false) and (this->_size + body.size() > this->_capacity))		// least recently used go first
+		_erase(this->_entries.find(this->_lru.back()));
+	this->_size += body.size();
+	this->_lru.push_front(key);
+	this->_entries[key] = {std::make_shared<std::string const>(std::move(body)), this->_lru.begin()};
+}
+
+bool	GzipCache::isEnabled( void ) const noexcept
+{
+	return (this->_capacity > 0);
+}
+
+bool	GzipCache::canHold( size_t size ) const noexcept
+{
+	return ((isEnabled() == true) and (size <= this->_capacity / GZIP_CACHE_ENTRY_SHARE));
+}
+
+void	GzipCache::_erase( std::unordered_map<std::string, t_Slot>::iterator it ) noexcept
+{
+	this->_size -= it->second.body->size();
+	this->_lru.erase(it->second.lru);
+	this->_entries.erase(it);
+}
@@ -0,0 +1,142 @@
+#include "GzipSource.hpp"
+
+GzipSource::GzipSource( BodySource* input, int level, off_t inputLength ) :
+	_input(input),
+	_stream(),
+	_level(level),
+	_started(false),
+	_finished(false),
+	_unflushed(false),
+	_inputLeft(inputLength),
+	_inPos(0),
+	_cache(nullptr)
+{
+
+}
+
+GzipSource::~GzipSource( void )
+{
+	if (this->_started == true)
+		deflateEnd(&this->_stream);
+	delete this->_input;
+}
+
+// bytes of the body read before the source was wrapped, deflated ahead of the input
+void	GzipSource::push( std::string_view bytes )
+{
+	if (this->_inputLeft != -1)
+	{
+		bytes = bytes.substr(0, this->_inputLeft);
+		this->_inputLeft -= bytes.size();
+	}
+	this->_inBuf.append(bytes);
+}
+
+// the whole output is handed to the cache under key once the stream ends, unless it outgrows it
+void	GzipSource::keepIn( GzipCache* cache, std::string const& key )
+{
+	if ((cache == nullptr) or (cache->isEnabled() == false))
+		return ;
+	this->_cache = cache;
+	this->_key = key;
+}
+
+// an input that stalls is flushed so the bytes it gave reach the client without waiting for more
+ssize_t	GzipSource::read( char* buffer, size_t length )
+{
+	int		flush = Z_NO_FLUSH, status = Z_OK;
+	size_t	produced = 0;
+
+	if ((this->_finished == true) or (length == 0))
+		return (0);
+	if ((this->_started == false) and (deflateInit2(&this->_stream, this->_level, Z_DEFLATED,
+		GZIP_WINDOW_BITS, GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK))
+		throw(ResponseException({"gzip stream could not be initialised"}, 500));
+	this->_started = true;
+	this->_stream.next_out = reinterpret_cast<Bytef*>(buffer);
+	this->_stream.avail_out = length;
+	while ((this->_stream.avail_out > 0) and (this->_finished == false))
+	{
+		if (this->_inPos == this->_inBuf.size())
+			_refill();
+		if (this->_inPos < this->_inBuf.size())
+			flush = Z_NO_FLUSH;
+		else if (_isInputDone() == true)
+			flush = Z_FINISH;
+		else if (this->_unflushed == true)
+			flush = Z_SYNC_FLUSH;
+		else
+			break ;
+		this->_stream.next_in = reinterpret_cast<Bytef*>(this->_inBuf.data() + this->_inPos);
+		this->_stream.avail_in = this->_inBuf.size() - this->_inPos;
+		status = deflate(&this->_stream, flush);
+		if ((status != Z_OK) and (status != Z_STREAM_END) and (status != Z_BUF_ERROR))
+			throw(ResponseException({"gzip stream error:", (this->_stream.msg != nullptr) ? this->_stream.msg : "unknown"}, 500));
+		this->_inPos = this->_inBuf.size() - this->_stream.avail_in;
+		if (flush == Z_NO_FLUSH)
+			this->_unflushed = true;
+		else if ((flush == Z_SYNC_FLUSH) and (this->_stream.avail_out > 0))		// otherwise the flush goes on next read
+			this->_unflushed = false;
+		if (status == Z_STREAM_END)
+			this->_finished = true;
+		else if (status == Z_BUF_ERROR)		// no progress possible
+			break ;
+	}
+	produced = length - this->_stream.avail_out;
+	_keep(buffer, produced);
+	return (produced);
+}
+
+bool	GzipSource::isDone( void ) const noexcept
+{
+	return (this->_finished);
+}
+
+// the input's fd while it may still give bytes, then nothing to wait for
+int		GzipSource::getFd( void ) const noexcept
+{
+	if (_isInputDone() == true)
+		return (-1);
+	return (this->_input->getFd());
+}
+
+bool	GzipSource::_isInputDone( void ) const noexcept
+{
+	return ((this->_inputLeft == 0) or (this->_input->isDone() == true));
+}
+
+void	GzipSource::_refill( void )
+{
+	size_t	length = HTTP_BUF_SIZE;
+	ssize_t	readChars = 0;
+
+	this->_inPos = 0;
+	this->_inBuf.clear();
+	if (_isInputDone() == true)
+		return ;
+	if (this->_inputLeft != -1)
+		length = std::min<size_t>(length, this->_inputLeft);
+	this->_inBuf.resize(length);
+	readChars = this->_input->read(this->_inBuf.data(), length);
+	this->_inBuf.resize(std::max<ssize_t>(readChars, 0));
+	if (this->_inputLeft != -1)
+		this->_inputLeft -= this->_inBuf.size();
+}
+
+void	GzipSource::_keep( char const* bytes, size_t length )
+{
+	if (this->_cache == nullptr)
+		return ;
+	if (this->_cache->canHold(this->_kept.size() + length) == false)
+	{
+		this->_cache = nullptr;
+		std::string().swap(this->_kept);
+		return ;
+	}
+	this->_kept.append(bytes, length);
+	if (this->_finished == true)
+	{
+		this->_cache->store(this->_key, std::move(this->_kept));
+		this->_cache = nullptr;
+	}
+}
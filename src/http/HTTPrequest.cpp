@@ -2,25 +2,19 @@
 
 void	HTTPrequest::parseHead( void )
 {
-	std::string strHead, strHeaders;
-	size_t		endHead=0, endReq=0;
+	size_t		headSize = 0;
 
 	if (this->_state != HTTP_REQ_HEAD_READING)
 		throw(RequestException({"instance in wrong state to parse head"}, 500));
 	_readHead();
 	if (isDoneReadingHead() == true)
 	{
-		endReq = this->_tmpHead.find(HTTP_TERM);
-		endHead = this->_tmpHead.find(HTTP_NL);		// look for headers
-		if (endHead >= endReq)
-			throw(RequestException({"no headers"}, 400));
-		strHead = this->_tmpHead.substr(0, endHead);
-		strHeaders = this->_tmpHead.substr(endHead + HTTP_NL.size(), endReq + HTTP_NL.size() - endHead - 1);
-		endReq += HTTP_TERM.size();
-		if ((endReq + 1) < this->_tmpHead.size())		// look for the beginning of the body
-			this->_tmpBody = this->_tmpHead.substr(endReq);
-		_setHead(strHead);
-		_setHeaders(strHeaders);
+		headSize = this->_parser.getHeadSize();
+		if (headSize < this->_headLength)		// the beginning of the body came with the head
+			this->_tmpBody.assign(this->_headBuf + headSize, this->_headLength - headSize);
+		_resolveHeaders();
+		_setHead();
+		_checkHeaders();
 		this->_validator.solvePath(this->_method, this->_url.path, getHost());
 		this->_statusCode = this->_validator.getStatusCode();
 		this->_root = this->_validator.getRoot();
@@ -28,11 +22,18 @@ void	HTTPrequest::parseHead( void )
 		if (this->_validator.solvePathFailed() == true)
 			throw(RequestException({"validation of config file failed"}, this->_validator.getStatusCode()));
 		_checkMaxBodySize();
+		_setBodyBuffering();
 		if (isDoneReadingBody())
 			_setBody(this->_tmpBody);
 	}
 }
 
+HTTPrequest::~HTTPrequest( void )
+{
+	if (this->_bodyFd != -1)
+		close(this->_bodyFd);
+}
+
 void	HTTPrequest::parseBody( void )
 {
 	if (isDoneReadingBody())
@@ -71,16 +72,13 @@ std::string	HTTPrequest::toString( void ) const noexcept
 	strReq += ".";
 	strReq += std::to_string(this->_version.minor);
 	strReq += HTTP_NL;
-	if (!this->_headers.empty())
+	for (size_t i = 0; i < this->_parser.getHeadersCount(); i++)
 	{
-		for (auto item : this->_headers)
-		{
-			strReq += item.first;
-			strReq += ":";
-			strReq += HTTP_SP;
-			strReq += item.second;
-			strReq += HTTP_NL;
-		}
+		strReq += this->_parser.getHeaderAt(i).name;
+		strReq += ":";
+		strReq += HTTP_SP;
+		strReq += this->_parser.getHeaderAt(i).value;
+		strReq += HTTP_NL;
 	}
 	strReq += HTTP_NL;
 	if (this->_body.empty() == false)
@@ -131,38 +129,31 @@ std::string 	HTTPrequest::getMethod( void ) const noexcept
 
 std::string		HTTPrequest::getHost( void ) const noexcept
 {
-	try
-	{
-		std::string	hostPort = this->_headers.find(HTTP_HEADER_HOST)->second;
-		size_t	semiColPos = hostPort.find(':');
-		return (hostPort.substr(0, semiColPos));
-	}
-	catch(const std::out_of_range& e) {
-		return ("");
-	}
+	return (std::string(this->_hostName));
 }
 
 std::string		HTTPrequest::getPort( void ) const noexcept
 {
-	try
-	{
-		std::string	hostPort = this->_headers.find(HTTP_HEADER_HOST)->second;
-		size_t	semiColPos = hostPort.find(':');
-		if (semiColPos == std::string::npos)
-			return (HTTP_DEF_PORT);
-		else
-			return (hostPort.substr(semiColPos + 1));
-	}
-	catch(const std::out_of_range& e) {
+	if (this->_parser.hasHeader(HDR_HOST) == false)
 		return ("");
-	}
+	else if (this->_hostPort.empty())
+		return (HTTP_DEF_PORT);
+	else
+		return (std::string(this->_hostPort));
 }
 
 size_t	HTTPrequest::getContentLength( void ) const noexcept
 {
+	if (isChunked() == true)		// known once the last chunk is decoded
+		return (this->_bodyReceived);
 	return (this->_contentLength);
 }
 
+int	HTTPrequest::getBodyFd( void ) const noexcept
+{
+	return (this->_bodyFd);
+}
+
 std::string	const&	HTTPrequest::getQueryRaw( void ) const noexcept
 {
 	return (this->_url.queryRaw);
@@ -170,22 +161,95 @@ std::string	const&	HTTPrequest::getQueryRaw( void ) const noexcept
 
 std::string	const	HTTPrequest::getCookie( void ) const noexcept
 {
-	if (this->_headers.count(HTTP_HEADER_COOKIE) != 0)
-		return (this->_headers.find(HTTP_HEADER_COOKIE)->second);
-	else
-		return std::string();
+	return (std::string(this->_parser.getHeader(HDR_COOKIE)));
 }
 
-std::string		HTTPrequest::getContentTypeBoundary( void ) const noexcept
+std::string_view	HTTPrequest::getIfNoneMatch( void ) const noexcept
+{
+	return (this->_parser.getHeader(HDR_IF_NONE_MATCH));
+}
+
+std::string_view	HTTPrequest::getIfModifiedSince( void ) const noexcept
+{
+	return (this->_parser.getHeader(HDR_IF_MOD_SINCE));
+}
+
+std::string_view	HTTPrequest::getRange( void ) const noexcept
+{
+	return (this->_parser.getHeader(HDR_RANGE));
+}
+
+std::string_view	HTTPrequest::getIfRange( void ) const noexcept
 {
-	std::string boundary = "";
-	if (this->_headers.count(HTTP_HEADER_CONT_TYPE) > 0)
+	return (this->_parser.getHeader(HDR_IF_RANGE));
+}
+
+uint8_t	HTTPrequest::getStaticCodings( void ) const noexcept
+{
+	return (this->_validator.getStaticCodings());
+}
+
+t_GzipConf const&	HTTPrequest::getGzip( void ) const noexcept
+{
+	return (this->_validator.getGzip());
+}
+
+t_TypesConf const&	HTTPrequest::getTypesConf( void ) const noexcept
+{
+	return (this->_validator.getTypesConf());
+}
+
+// codings of Accept-Encoding the server knows, q=0 refuses one, * stands for the others
+uint8_t	HTTPrequest::getAcceptedCodings( void ) const noexcept
+{
+	std::string_view	list = this->_parser.getHeader(HDR_ACCEPT_ENCODING), item, name;
+	uint8_t				accepted = 0, refused = 0, coding = 0;
+	size_t				delim = 0, qValue = 0;
+
+	while (list.empty() == false)
 	{
-		std::string contentType = this->_headers.find(HTTP_HEADER_CONT_TYPE)->second;
-		size_t delim = contentType.find('=');
-		boundary = contentType.substr(delim + 1, contentType.length() - delim);
+		delim = std::min(list.find(','), list.size());
+		item = list.substr(0, delim);
+		list.remove_prefix(std::min(delim + 1, list.size()));
+		name = item.substr(0, item.find(';'));
+		name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+		name = name.substr(0, name.find_last_not_of(" \t") + 1);
+		if (HeaderTable::equalNames(name, "gzip") or HeaderTable::equalNames(name, "x-gzip"))
+			coding = CODING_GZIP;
+		else if (HeaderTable::equalNames(name, "br"))
+			coding = CODING_BR;
+		else if (name == "*")
+			coding = CODING_GZIP | CODING_BR;
+		else
+			continue ;
+		qValue = item.find("q=");
+		if ((qValue != std::string_view::npos) and (item.find_first_not_of("0.", qValue + 2) >= item.find_last_not_of(" \t") + 1))
+			refused |= (name == "*") ? 0 : coding;		// q=0, q=0.0 ...
+		else
+			accepted |= coding;
 	}
-	return (boundary);
+	return (accepted & ~refused);
+}
+
+std::string		HTTPrequest::getContentTypeBoundary( void ) const noexcept
+{
+	std::string_view	contentType = this->_parser.getHeader(HDR_CONT_TYPE);
+	size_t				delim = contentType.find('=');
+
+	if (delim == std::string_view::npos)
+		return ("");
+	return (std::string(contentType.substr(delim + 1)));
+}
+
+std::string	HTTPrequest::takeSurplus( void ) noexcept
+{
+	std::string	surplus = std::move(this->_surplus);
+
+	surplus.append(this->_pending, this->_pendingPos);
+	this->_surplus.clear();
+	this->_pending.clear();
+	this->_pendingPos = 0;
+	return (surplus);
 }
 
 std::string const&	HTTPrequest::getServName( void ) const noexcept
@@ -193,6 +257,11 @@ std::string const&	HTTPrequest::getServName( void ) const noexcept
 	return(this->_validator.getServName());
 }
 
+std::string const&	HTTPrequest::getServerHeader( void ) const noexcept
+{
+	return(this->_validator.getServerHeader());
+}
+
 path_t const&	HTTPrequest::getRealPath( void ) const noexcept
 {
 
@@ -209,17 +278,14 @@ path_t const&	HTTPrequest::getRoot( void ) const noexcept
 	return (this->_validator.getRoot());
 }
 
-bool	HTTPrequest::isEndConn( void ) noexcept
+bool	HTTPrequest::isEndConn( void ) const noexcept
 {
-	if (this->_headers.count(HTTP_HEADER_CONN) == 0)
-		return (false);
-	return (this->_headers.find(HTTP_HEADER_CONN)->second == "close");
+	return (this->_endConn);
 }
 
 bool	HTTPrequest::isChunked( void ) const noexcept
 {
-	return ((this->_headers.count(HTTP_HEADER_TRANS_ENCODING) > 0) &&
-			(this->_headers.find(HTTP_HEADER_TRANS_ENCODING)->second == "chunked"));
+	return (this->_chunked);
 }
 
 bool	HTTPrequest::isDoneReadingHead( void ) const noexcept
@@ -237,64 +303,152 @@ bool	HTTPrequest::hasBodyToRead( void ) const noexcept
 	if (isDoneReadingBody())
 		return (false);
 	else if (isChunked())
-		return (this->_tmpBody.find(HTTP_TERM) == std::string::npos);
+		return (this->_decoder.isDone() == false);
 	else
-		return (this->_tmpBody.size() < this->_contentLength);
+		return (this->_bodyReceived < this->_contentLength);
 }
 
-void	HTTPrequest::_setHead( std::string const& header )
+bool	HTTPrequest::isBodyLeftUnread( void ) const noexcept
 {
-	std::istringstream	stream(header);
-	std::string 		method, url, version;
-	char				spaceChar = *HTTP_SP.data();
+	std::string_view	contentLength = this->_parser.getHeader(HDR_CONT_LEN);
 
-	if (! std::getline(stream, method, spaceChar))
-		throw(RequestException({"invalid header:", header}, 400));
-	_setMethod(method);
-	if (! std::getline(stream, url, spaceChar))
-		throw(RequestException({"invalid header:", header}, 400));
-	_setURL(url);
-	if (! std::getline(stream, version, spaceChar))
-		throw(RequestException({"invalid header:", header}, 400));
-	_setVersion(version);
+	if (isDoneReadingBody())
+		return (false);
+	return (this->_chunked or ((contentLength.empty() == false) and (contentLength != "0")));
 }
 
-void	HTTPrequest::_setHeaders( std::string const& strHeaders )
+bool	HTTPrequest::hasPendingInput( void ) const noexcept
 {
-	try {
-		HTTPstruct::_setHeaders(strHeaders);
+	return (this->_pendingPos < this->_pending.size());
+}
+
+// the whole body is collected before the CGI starts, instead of being piped to it while it arrives
+bool	HTTPrequest::isBodyBuffered( void ) const noexcept
+{
+	return (isFileUpload() and (isChunked() or (this->_contentLength > this->_bodyBufferSize)));
+}
+
+bool	HTTPrequest::isBodySpilled( void ) const noexcept
+{
+	return (this->_bodyFd != -1);
+}
+
+bool	HTTPrequest::isBodyStreamed( void ) const noexcept
+{
+	return (isFileUpload() and (isBodyBuffered() == false));
+}
+
+// false while the streamed body waits for the CGI to make room
+bool	HTTPrequest::canReadBody( void ) const noexcept
+{
+	return ((isBodyStreamed() == false) or (this->_bodyRing.full() == false));
+}
+
+bool	HTTPrequest::hasBodyToWrite( void ) const noexcept
+{
+	if (isBodyStreamed() == true)
+		return (this->_bodyRing.empty() == false);
+	return (this->_bodySent < this->_tmpBody.size());
+}
+
+// hands the CGI what it can take now, 0 when its pipe is full
+ssize_t	HTTPrequest::writeBody( int fd )
+{
+	ssize_t	written = -1;
+
+	if (isBodyStreamed() == true)
+		written = this->_bodyRing.writeTo(fd);
+	else if (this->_bodySent < this->_tmpBody.size())
+	{
+		written = write(fd, this->_tmpBody.data() + this->_bodySent, this->_tmpBody.size() - this->_bodySent);
+		if ((written < 0) and ((errno == EAGAIN) or (errno == EWOULDBLOCK)))
+			written = 0;
+		else if (written > 0)
+			this->_bodySent += written;
 	}
-	catch (const HTTPexception& e) {
-		throw(RequestException(e));
+	else
+		written = 0;
+	if (written < 0)
+		throw(ServerException({"CGI upload pipe not available"}));
+	return (written);
+}
+
+void	HTTPrequest::_resolveHeaders( void ) noexcept
+{
+	std::string_view	host = this->_parser.getHeader(HDR_HOST);
+	std::string_view	connection = this->_parser.getHeader(HDR_CONN);
+	std::string_view	option;
+	size_t				delim = host.find(':');
+
+	this->_hostName = host.substr(0, delim);
+	if (delim != std::string_view::npos)
+		this->_hostPort = host.substr(delim + 1);
+	this->_chunked = HeaderTable::equalNames(this->_parser.getHeader(HDR_TRANS_ENCODING), "chunked");
+	while (connection.empty() == false)		// comma separated list of options
+	{
+		delim = std::min(connection.find(','), connection.size());
+		option = connection.substr(0, delim);
+		option = option.substr(0, option.find_last_not_of(" \t") + 1);
+		if (HeaderTable::equalNames(option, "close") == true)
+			this->_endConn = true;
+		connection.remove_prefix(delim);
+		connection.remove_prefix(std::min(connection.find_first_not_of(", \t"), connection.size()));
 	}
-	if (this->_headers.count(HTTP_HEADER_HOST) == 0)		// missing Host header
+}
+
+void	HTTPrequest::_setHead( void )
+{
+	_setMethod(this->_parser.getMethod());
+	_setURL(std::string(this->_parser.getTarget()));
+	if (this->_parser.getVersion() != "HTTP/1.1")		// anything else is either rejected or spelled differently
+		_setVersion(std::string(this->_parser.getVersion()));
+}
+
+void	HTTPrequest::_checkHeaders( void )
+{
+	std::string_view	host = this->_parser.getHeader(HDR_HOST);
+	std::string_view	contentLength = this->_parser.getHeader(HDR_CONT_LEN);
+	std::from_chars_result	converted;
+	std::string				rawBody;
+
+	if (this->_parser.hasHeader(HDR_HOST) == false)		// missing Host header
 		throw(RequestException({"no Host header"}, 444));
 	else if (this->_url.host == "")
-		_setHostPort(this->_headers.find(HTTP_HEADER_HOST)->second);
-	else if (this->_headers.find(HTTP_HEADER_HOST)->second.find(this->_url.host) == std::string::npos)
+		_setHostPort(std::string(host));
+	else if (host.find(this->_url.host) == std::string_view::npos)
 		throw(RequestException({"hosts do not match"}, 412));
 	if ((this->_method == HTTP_GET) or (this->_method == HTTP_DELETE))
+	{
+		this->_surplus = std::move(this->_tmpBody);		// bodyless, what came after the head is the next request
+		this->_tmpBody.clear();
 		return ;
+	}
 
-	if (this->_headers.count(HTTP_HEADER_CONT_TYPE) == 0)
+	if (this->_parser.hasHeader(HDR_CONT_TYPE) == false)
 		throw(RequestException({HTTP_HEADER_CONT_TYPE, "required"}, 400));
-	if (this->_headers.count(HTTP_HEADER_CONT_LEN) == 0)
+	if (this->_parser.hasHeader(HDR_CONT_LEN) == false)
 	{
-		if (this->_headers.count(HTTP_HEADER_TRANS_ENCODING) == 0)
+		if (this->_parser.hasHeader(HDR_TRANS_ENCODING) == false)
 			throw(RequestException({HTTP_HEADER_CONT_LEN, "required"}, 411));
-		else if (this->_headers.find(HTTP_HEADER_TRANS_ENCODING)->second != "chunked")
+		else if (isChunked() == false)
 			throw(RequestException({HTTP_HEADER_TRANS_ENCODING, "required"}, 400));
+		rawBody = std::move(this->_tmpBody);		// decode what came with the head
+		this->_tmpBody.clear();
+		_takeBodyBytes(rawBody.data(), rawBody.size());
 	}
+	else if (isChunked() == true)
+		throw(RequestException({"both", HTTP_HEADER_CONT_LEN, "and", HTTP_HEADER_TRANS_ENCODING}, 400));
 	else
 	{
-		try {
-			this->_contentLength = std::stoull(this->_headers.find(HTTP_HEADER_CONT_LEN)->second);
-		}
-		catch (const std::exception& e) {
+		converted = std::from_chars(contentLength.data(), contentLength.data() + contentLength.size(), this->_contentLength);
+		if ((converted.ec != std::errc()) or (converted.ptr != contentLength.data() + contentLength.size()))
 			throw(RequestException({"invalid Content-Length"}, 400));
+		if (this->_tmpBody.size() > this->_contentLength)
+		{
+			this->_surplus = this->_tmpBody.substr(this->_contentLength);
+			this->_tmpBody.resize(this->_contentLength);
 		}
-		if (this->_tmpHead.size() > this->_contentLength)
-			this->_tmpBody = this->_tmpBody.substr(0, this->_contentLength);
+		this->_bodyReceived = this->_tmpBody.size();
 	}
 }
 
@@ -310,39 +464,59 @@ void	HTTPrequest::_setVersion( std::string const& strVersion )
 
 void	HTTPrequest::_setBody( std::string const& body )
 {
-	size_t		delim = 0;
-	std::string	bodyToStore;
+	if (isChunked() == false)
+		this->_tmpBody = body.substr(0, this->_contentLength);
+	HTTPstruct::_setBody(this->_tmpBody);
+}
+
+ssize_t	HTTPrequest::_receive( char *buffer, size_t size )
+{
+	size_t	fromPending = std::min(size, this->_pending.size() - this->_pendingPos);
+
+	if (fromPending == 0)
+		return (recv(this->_socket, buffer, size, 0));
+	std::copy_n(this->_pending.data() + this->_pendingPos, fromPending, buffer);
+	this->_pendingPos += fromPending;
+	return (fromPending);
+}
+
+void	HTTPrequest::_takeBodyBytes( char const* bytes, size_t size )
+{
+	size_t	bodyBytes = size;
 
-	if (isChunked())
+	if (this->_chunked == true)
 	{
-		delim = body.find(HTTP_TERM);
-		if (delim > this->_maxBodySize)
-			throw(RequestException({"content body is longer than the maximum allowed"}, 413));
-		delim += HTTP_TERM.size();
-		this->_tmpBody = _unchunkBody(body.substr(0, delim));
+		bodyBytes = this->_decoder.decode(bytes, size, this->_tmpBody);
+		this->_bodyReceived = this->_decoder.getDecodedSize();
 	}
 	else
-		this->_tmpBody = body.substr(0, this->_contentLength);
-	HTTPstruct::_setBody(this->_tmpBody);
+	{
+		bodyBytes = std::min(size, this->_contentLength - this->_bodyReceived);
+		if (isBodyStreamed() == true)
+			this->_bodyRing.push(bytes, bodyBytes);
+		else
+			this->_tmpBody.append(bytes, bodyBytes);
+		this->_bodyReceived += bodyBytes;
+	}
+	this->_surplus.append(bytes + bodyBytes, size - bodyBytes);
+	if (isBodyBuffered() and (isBodySpilled() or (this->_tmpBody.size() > this->_bodyBufferSize)))
+		_spillBody();
 }
 
 void	HTTPrequest::_readHead( void )
 {
-	char	buffer[HTTP_MAX_HEADER_SIZE];
 	ssize_t	charsRead = -1;
 
-	std::fill(buffer, buffer + HTTP_MAX_HEADER_SIZE, 0);
-	charsRead = recv(this->_socket, buffer, HTTP_MAX_HEADER_SIZE, 0);
+	charsRead = _receive(this->_headBuf + this->_headLength, HTTP_MAX_HEADER_SIZE - this->_headLength);
 	if (charsRead < 0)
 		throw(ServerException({"unavailable socket"}));
 	else if (charsRead == 0)
 		throw(EndConnectionException({}));
-	else if (this->_tmpHead.size() + charsRead > HTTP_MAX_HEADER_SIZE)
-		throw(RequestException({"head too large"}, 431));
-	_checkTimeout();
-	this->_tmpHead += std::string(buffer, buffer + charsRead);
-	if (this->_tmpHead.find(HTTP_TERM) != std::string::npos)
+	this->_headLength += charsRead;
+	if (this->_parser.feed(this->_headBuf, this->_headLength) == true)
 		this->_state = HTTP_REQ_HEAD_PARSING;
+	else if (this->_headLength == HTTP_MAX_HEADER_SIZE)
+		throw(RequestException({"head too large"}, 431));
 }
 
 void	HTTPrequest::_readBody( void )
@@ -350,14 +524,18 @@ void	HTTPrequest::_readBody( void )
     ssize_t charsRead = -1;
     char	buffer[HTTP_BUF_SIZE];
 
+	if (canReadBody() == false)
+		return ;
 	std::fill(buffer, buffer + HTTP_BUF_SIZE, 0);
-	charsRead = recv(this->_socket, buffer, HTTP_BUF_SIZE, 0);
+	if (isBodyStreamed() == true)
+		charsRead = _receive(buffer, std::min<size_t>(HTTP_BUF_SIZE, this->_bodyRing.space()));
+	else
+		charsRead = _receive(buffer, HTTP_BUF_SIZE);
 	if (charsRead < 0 )
 		throw(ServerException({"unavailable socket"}));
 	else if (charsRead == 0)
 		throw(EndConnectionException({}));
-	_checkTimeout();
-	this->_tmpBody += std::string(buffer, buffer + charsRead);
+	_takeBodyBytes(buffer, charsRead);
 	if (hasBodyToRead() == false)
 		this->_state = HTTP_REQ_DONE;
 }
@@ -372,7 +550,7 @@ void	HTTPrequest::_setTypeAndState( void ) noexcept
 			this->_type = HTTP_STATIC;
 		this->_state = HTTP_REQ_DONE;
 	}
-	else if (this->_headers.count(HTTP_HEADER_CONT_TYPE) > 0)		// request with body
+	else if (this->_parser.hasHeader(HDR_CONT_TYPE) == true)		// request with body
 	{
 		this->_type = HTTP_CGI_FILE_UPL;
 		if (hasBodyToRead())
@@ -401,8 +579,9 @@ void	HTTPrequest::_checkMaxBodySize( void )
 		return;
 	if (isChunked() == true)
 	{
-		if (this->_validator.getMaxBodySize() < this->_tmpBody.size())
-			throw(RequestException({"Content-Length longer than config max body length"}, 413));
+		if (this->_validator.getMaxBodySize() < this->_decoder.getDecodedSize())
+			throw(RequestException({"content body is longer than the maximum allowed"}, 413));
+		this->_decoder.setMaxSize(this->_validator.getMaxBodySize());		// checked on every chunk size from now on
 	}
 	else if (isFileUpload() == true)
 	{
@@ -414,6 +593,56 @@ void	HTTPrequest::_checkMaxBodySize( void )
 	this->_maxBodySize = this->_validator.getMaxBodySize();
 }
 
+void	HTTPrequest::_setBodyBuffering( void )
+{
+	if (isFileUpload() == false)
+		return ;
+	this->_bodyBufferSize = this->_validator.getBodyBufferSize();
+	if (isBodyBuffered() and (this->_tmpBody.size() > this->_bodyBufferSize))
+		_spillBody();
+	else if (isBodyStreamed() == true)		// what came with the head is the first part of the stream
+	{
+		this->_bodyRing.reserve(std::max<size_t>(1, std::min<size_t>(HTTP_BODY_RING_SIZE, this->_contentLength)));
+		this->_bodyRing.push(this->_tmpBody.data(), this->_tmpBody.size());
+		this->_tmpBody.clear();
+	}
+}
+
+void	HTTPrequest::_spillBody( void )
+{
+	size_t	written = 0;
+	ssize_t	writeRet = -1;
+
+	if (this->_bodyFd == -1)
+		this->_bodyFd = _openTempFile();
+	while (written < this->_tmpBody.size())
+	{
+		writeRet = write(this->_bodyFd, this->_tmpBody.data() + written, this->_tmpBody.size() - written);
+		if (writeRet < 0)
+			throw(RequestException({"could not write the request body to a temporary file"}, 500));
+		written += writeRet;
+	}
+	this->_tmpBody.clear();
+}
+
+int	HTTPrequest::_openTempFile( void )
+{
+	char	tmpName[] = HTTP_BODY_TEMP_DIR "/webserv-body-XXXXXX";
+	int		fd = -1;
+
+#ifdef O_TMPFILE
+	fd = open(HTTP_BODY_TEMP_DIR, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);		// never visible in the directory
+	if (fd != -1)
+		return (fd);
+#endif
+	fd = mkstemp(tmpName);
+	if (fd == -1)
+		throw(RequestException({"could not create a temporary file for the request body"}, 500));
+	unlink(tmpName);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	return (fd);
+}
+
 std::string	HTTPrequest::_encodeSpaces( std::string const& strWithSpaces) const noexcept
 {
 	std::string	strNoSpaces = strWithSpaces;
@@ -440,7 +669,7 @@ std::string	HTTPrequest::_decodeSpaces( std::string const& strNoSpaces) const no
 	return (strWithSpaces);
 }
 
-void    HTTPrequest::_setMethod( std::string const& strMethod )
+void    HTTPrequest::_setMethod( std::string_view strMethod )
 {
 	if (strMethod == "GET")
 		this->_method = HTTP_GET;
@@ -453,9 +682,9 @@ void    HTTPrequest::_setMethod( std::string const& strMethod )
 			(strMethod == "PATCH") or
 			(strMethod == "OPTIONS") or
 			(strMethod == "CONNECT"))
-		throw(RequestException({"unsupported HTTP method:", strMethod}, 501));
+		throw(RequestException({"unsupported HTTP method:", std::string(strMethod)}, 501));
 	else
-		throw(RequestException({"unknown HTTP method:", strMethod}, 400));
+		throw(RequestException({"unknown HTTP method:", std::string(strMethod)}, 400));
 }
 
 void	HTTPrequest::_setURL( std::string const& strURL )
@@ -546,27 +775,23 @@ void	HTTPrequest::_setPath( std::string const& strPath )
 
 void	HTTPrequest::_setQuery( std::string const& queries )
 {
-	std::string			key, value, keyValue=queries;
-	size_t 				del1, del2;
+	std::string_view	keyValue;
+	size_t 				start = 1, del1, del2;		// skip leading '?'
 
 	if (queries == "?")
 		throw(RequestException({"empty query"}, 400));
-	this->_url.queryRaw = keyValue.substr(1);
+	this->_url.queryRaw = queries.substr(1);
 	while (true)
 	{
-		keyValue = keyValue.substr(1);	// remove leading '?' or '&'
-		del1 = keyValue.find('=');
-		if (del1 == std::string::npos)
-			throw(RequestException({"invalid query:", keyValue}, 400));
-		del2 = keyValue.find('&');
-		key = keyValue.substr(0, del1);
-		value = keyValue.substr(del1 + 1, del2 - del1 - 1);
-		if (key.empty())
-			throw(RequestException({"invalid query:", keyValue}, 400));
-		this->_url.query.insert({key, value});
+		del2 = ByteScan::find(queries, '&', start);
+		keyValue = std::string_view(queries).substr(start, del2 - start);
+		del1 = ByteScan::find(keyValue, '=');
+		if ((del1 == std::string::npos) or (del1 == 0))
+			throw(RequestException({"invalid query:", std::string(keyValue)}, 400));
+		this->_url.query.insert({std::string(keyValue.substr(0, del1)), std::string(keyValue.substr(del1 + 1))});
 		if (del2 == std::string::npos)
 			break;
-		keyValue = keyValue.substr(del2);
+		start = del2 + 1;
 	}
 }
 
@@ -574,26 +799,3 @@ void	HTTPrequest::_setFragment( std::string const& strFragment)
 {
 	this->_url.fragment = strFragment.substr(1);
 }
-
-std::string	HTTPrequest::_unchunkBody( std::string const& chunkedBody )
-{
-	size_t		sizeChunk=0, delimiter=0;
-	std::string	tmpChunkedBody, unchunkedBody;
-
-	tmpChunkedBody = chunkedBody;
-	do
-	{
-		delimiter = tmpChunkedBody.find(HTTP_NL);
-		if (delimiter == std::string::npos)
-			throw(HTTPexception({"bad chunking"}, 400));
-		try {
-			sizeChunk = std::stoul(tmpChunkedBody.substr(0, delimiter), nullptr, 16);
-			unchunkedBody += tmpChunkedBody.substr(delimiter + HTTP_NL.size(), sizeChunk);
-			tmpChunkedBody = tmpChunkedBody.substr(delimiter + sizeChunk + HTTP_NL.size() * 2);
-		}
-		catch(const std::exception& e){
-			throw(HTTPexception({"bad chunking"}, 400));
-		}
-	} while (sizeChunk != 0);
-	return (unchunkedBody);
-}
\ No newline at end of file
@@ -3,7 +3,18 @@
 HTTPresponse::HTTPresponse( int socket, int statusCode, HTTPtype type ) :
 	HTTPstruct(socket, statusCode, type) ,
 	_HTMLfd(-1),
-	_contentLengthWrite(0)
+	_source(nullptr),
+	_bodyLength(0),
+	_bodyQueued(0),
+	_bodyComplete(false),
+	_contentLengthWrite(0),
+	_varyEncoding(false),
+	_gzip(nullptr),
+	_gzipAccepted(false),
+	_gzipCache(nullptr),
+	_mimeTypes(nullptr),
+	_typesConf(nullptr),
+	_lastModified(-1)
 {
 	if (isStatic() == true)
 		this->_state = HTTP_RESP_HTML_READING;
@@ -11,74 +22,81 @@ HTTPresponse::HTTPresponse( int socket, int statusCode, HTTPtype type ) :
 		this->_state = HTTP_RESP_PARSING;
 }
 
-void	HTTPresponse::parseCGI( std::string const& CGIresp )
+HTTPresponse::~HTTPresponse( void )
 {
-	std::string headers;
-	size_t		delimiter;
-
-	if ((isCGI() == false) or (isParsingNeeded() == false))
-		throw(ResponseException({"instance in wrong state or type to perfom action"}, 500));
-	delimiter = CGIresp.find(HTTP_TERM);
-	if (delimiter == std::string::npos)
-		throw(ResponseException({"no headers terminator in CGI response"}, 500));
-	delimiter += HTTP_TERM.size();
-	headers = CGIresp.substr(0, delimiter - HTTP_NL.size());
-	this->_tmpBody = CGIresp.substr(delimiter);
-	if (this->_tmpBody.empty() == true)
-		throw(ResponseException({"CGI didn't provide any body"}, 500));
-	_setVersion(HTTP_DEF_VERSION);
-	_setHeaders(headers);
-	_addHeader(HTTP_HEADER_DATE, _getDateTime());
-	HTTPstruct::_setBody(this->_tmpBody);
-	this->_state = HTTP_RESP_WRITING;
-	this->_strSelf = toString();
+	delete this->_source;
 }
 
-void	HTTPresponse::parseNotCGI( std::string const& servName )
+// serverLine: "Server: name\r\n" rendered once for the vhost, it outlives the response
+void	HTTPresponse::parseNotCGI( std::string const& serverLine )
 {
 	if ((isCGI() == true) or (isParsingNeeded() == false))
 		throw(ResponseException({"instance in wrong state or type to perfom action"}, 500));
 	_setVersion(HTTP_DEF_VERSION);
-	_addHeader(HTTP_HEADER_DATE, _getDateTime());
-	_addHeader(HTTP_HEADER_SERVER, servName);
+	this->_serverLine = serverLine;
 	if (isDelete())				// DELETE responses are bodyless
 		this->_statusCode = 204;
-	else
+	else if (this->_statusCode != 304)		// a 304 only carries the validators
 	{
-		_addHeader(HTTP_HEADER_CONT_LEN, std::to_string(this->_tmpBody.size()));
-		_addHeader(HTTP_HEADER_CONT_TYPE, _getContTypeFromFile(this->_targetFile));
+		if (this->_cachedFile == nullptr)		// a cached file brings its length and type pre-rendered
+		{
+			if (this->_source == nullptr)
+				_addHeader(HTTP_HEADER_CONT_LEN, "0");
+			else if (this->_bodyLength == -1)		// length known only at the end, each read goes out as a chunk
+				_addHeader(HTTP_HEADER_TRANS_ENCODING, "chunked");
+			else
+				_addHeader(HTTP_HEADER_CONT_LEN, std::to_string(this->_bodyLength));
+			if (this->_contentType.empty() == false)
+				_addHeader(HTTP_HEADER_CONT_TYPE, this->_contentType);
+			else if ((this->_typeLine = _getContTypeLine(this->_targetFile)).empty() == true)
+				_addHeader(HTTP_HEADER_CONT_TYPE, _getContTypeFromFile(this->_targetFile));
+		}
 		if (isRedirection() == true)
 		{
 			if (this->_targetFile.empty() == true)
 				throw(ResponseException({"redirect file target not given"}, 500));
 			_addHeader(HTTP_HEADER_LOC, this->_targetFile);
 		}
-		HTTPstruct::_setBody(this->_tmpBody);
 	}
+	if ((this->_etag.empty() == false) and ((this->_statusCode == 200) or (this->_statusCode == 206) or (this->_statusCode == 304)))
+	{
+		_addHeader(HTTP_HEADER_ETAG, this->_etag);
+		_addHeader(HTTP_HEADER_LAST_MOD, _getDateTime(this->_lastModified));
+		if ((this->_statusCode != 304) and (this->_etag.compare(0, 2, "W/") != 0))
+			_addHeader(HTTP_HEADER_ACCEPT_RANGES, std::string(RANGE_UNIT));
+	}
+	_addEncodingHeaders();
 	this->_state = HTTP_RESP_WRITING;
-	this->_strSelf = toString();
+	this->_output.append(toString());
 }
 
-void	HTTPresponse::readStaticFile( void )
+// pulls from the source until the high watermark or until it has nothing more for now
+void	HTTPresponse::fillBody( void )
 {
-    ssize_t 	readChar = -1;
-    char        buffer[HTTP_BUF_SIZE];
+	BufferChain	bytes;
+	size_t		room = 0;
 
-	if ((isStatic() == false) or (isDoneReadingHTML() == true))
-		throw(ResponseException({"instance in wrong state or type to perfom action2"}, 500));
-	std::fill(buffer, buffer + HTTP_BUF_SIZE, 0);
-	readChar = read(this->_HTMLfd, buffer, HTTP_BUF_SIZE);
-	if (readChar < 0)
+	if (this->_source == nullptr)
+		throw(ResponseException({"instance in wrong state or type to perfom action"}, 500));
+	if (isCGI() and isParsingNeeded())
 	{
-		close(this->_HTMLfd);
-		if (this->_targetFile.empty() == true)
-			throw(ResponseException({"targetFile not set"}, 500));
-		else
-			throw(ResponseException({"file", this->_targetFile, "not available"}, 500));
+		_readCGIhead();
+		if (isParsingNeeded() == true)
+			return ;
+	}
+	while ((room = _getBodyRoom()) > 0)
+	{
+		if (this->_source->readInto(bytes, room) == 0)
+			break ;
+		_queueBody(std::move(bytes));
+	}
+	if ((this->_bodyComplete == false) and (this->_source->isDone() == true))
+	{
+		if (this->_bodyLength != -1)
+			throw(ResponseException({"body ended before its Content-Length"}, 500));
+		this->_output.append(HTTP_LAST_CHUNK);
+		this->_bodyComplete = true;
 	}
-	this->_tmpBody += std::string(buffer, buffer + readChar);
-	if (readChar < HTTP_BUF_SIZE)
-		this->_state = HTTP_RESP_PARSING;
 }
 
 // Function to convert file_time_type to string
@@ -86,8 +104,9 @@ static std::string fileTimeToString(std::filesystem::file_time_type time)
 {
 	auto timePoint = std::chrono::time_point_cast<std::chrono::system_clock::duration>(time - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
 	std::time_t t = std::chrono::system_clock::to_time_t(timePoint);
+	std::tm tmBuf;
 	std::stringstream ss;
-	ss << std::put_time(std::localtime(&t), "%d/%m/%Y %H:%M:%S");
+	ss << std::put_time(localtime_r(&t, &tmBuf), "%d/%m/%Y %H:%M:%S");
 	return ss.str();
 }
 
@@ -113,6 +132,16 @@ static std::string formatSize(uintmax_t size)
 	return oss.str();
 }
 
+static std::string	listingRow( std::filesystem::directory_entry const& entry, size_t rootLength, bool isFolder )
+{
+	std::string	name = entry.path().filename().string();
+	std::string	path = std::filesystem::weakly_canonical(entry).string().substr(rootLength);
+
+	if (isFolder == true)
+		return ("<tr><td><a href=\"" + path + "/" + "\">" + name + "/" + "</a></td><td>" + "</td><td>" + fileTimeToString(std::filesystem::last_write_time(entry)) + "</td></tr>");
+	return ("<tr><td><a href=\"" + path + "\">" + name + "</a></td><td>" + formatSize(std::filesystem::file_size(entry)) +  "</td><td>" + fileTimeToString(std::filesystem::last_write_time(entry)) + "</td></tr>");
+}
+
 void	HTTPresponse::listContentDirectory( void )
 {
 	// index of ....			[Header]
@@ -123,6 +152,8 @@ void	HTTPresponse::listContentDirectory( void )
 	// Files [file 3DigitSize	[DD/MM/YYYY, HH:MM::SS]]
 	std::set<std::filesystem::directory_entry> folders;
 	std::set<std::filesystem::directory_entry> files;
+	std::vector<std::filesystem::directory_entry> entries;
+	std::string	head;
 
 	// Populating folders and files sets
 	if ((isAutoIndex() == false) or (this->_state != HTTP_RESP_PARSING))
@@ -135,7 +166,7 @@ void	HTTPresponse::listContentDirectory( void )
 			files.insert(entry);
 	}
 	// Header part of the html:
-	_tmpBody += R"(
+	head += R"(
 		<!DOCTYPE html>
 		<html lang="en">
 		<head>
@@ -206,25 +237,27 @@ void	HTTPresponse::listContentDirectory( void )
 	while (i < tmpRoot.length() && parentDir[i] == tmpRoot[i])
 		i++;
 	if (!parentDir.empty())
-		_tmpBody += "<tr><td><a href=\"" + parentDir.substr(i) + "\">[Parent directory]</a></td><td></td><td></td></tr>";
-	_tmpBody += "<table><thead><tr><th>Name</th><th>Size</th><th>Date Modified</th></tr></thead><tbody>";
-	// Inserting folders into HTML
-	std::string name;
-	std::string path;
-	for (const auto& folder : folders)
+		head += "<tr><td><a href=\"" + parentDir.substr(i) + "\">[Parent directory]</a></td><td></td><td></td></tr>";
+	head += "<table><thead><tr><th>Name</th><th>Size</th><th>Date Modified</th></tr></thead><tbody>";
+	// Rows are rendered one by one while the client reads the page, folders first
+	entries.assign(folders.begin(), folders.end());
+	entries.insert(entries.end(), files.begin(), files.end());
+	setBodySource(new GeneratorSource([head = std::move(head), entries = std::move(entries), nFolders = folders.size(),
+		rootLength = _root.string().length(), step = size_t(0)]( std::string& piece ) mutable -> bool
 	{
-		name = folder.path().filename().string();
-		path = std::filesystem::weakly_canonical(folder).string().substr(_root.string().length());
-		_tmpBody += "<tr><td><a href=\"" + path + "/" + "\">" + name + "/" + "</a></td><td>" + "</td><td>" + fileTimeToString(std::filesystem::last_write_time(folder)) + "</td></tr>";
-	}
-	// Inserting files into HTML
-	for (const auto& file : files)
-	{
-		name = file.path().filename().string();
-		path = std::filesystem::weakly_canonical(file).string().substr(_root.string().length());
-		_tmpBody += "<tr><td><a href=\"" + path + "\">" + name + "</a></td><td>" + formatSize(std::filesystem::file_size(file)) +  "</td><td>" + fileTimeToString(std::filesystem::last_write_time(file)) + "</td></tr>";
-	}
-	_tmpBody += "</tbody></table></div></body></html>";
+		if (step == 0)
+			piece = head;
+		else if (step <= entries.size())
+			piece = listingRow(entries[step - 1], rootLength, step <= nFolders);
+		else
+		{
+			piece = "</tbody></table></div></body></html>";
+			return (false);
+		}
+		step++;
+		return (true);
+	}));
+	_compressBody(_getContTypeFromFile(this->_targetFile));
 }
 
 void	HTTPresponse::removeFile( void ) const
@@ -235,89 +268,144 @@ void	HTTPresponse::removeFile( void ) const
 		throw(ResponseException({"resource", this->_targetFile, "could not be deleted"}, 500));
 }
 
+// head and queued body leave together in one gather write, a direct source follows them
 void	HTTPresponse::writeContent( void )
 {
-    ssize_t writtenChars = -1;
-	size_t	charsToWrite = 0;
+	ssize_t	writtenChars = 0;
 
 	if (isDoneWriting() == true)
 		throw(ResponseException({"instance in wrong state or type to perfom action"}, 500));
-	else if (this->_contentLengthWrite == 0)
-		_resetTimeout();
-	if ((this->_strSelf.size()) < HTTP_BUF_SIZE)
-	{
-		charsToWrite = this->_strSelf.size();
-		this->_state = HTTP_RESP_DONE;
-	}
-	else
-		charsToWrite = HTTP_BUF_SIZE;
-	writtenChars = send(this->_socket, this->_strSelf.substr(0, charsToWrite).c_str(), charsToWrite, 0);
+	if ((this->_source != nullptr) and (this->_source->isDirect() == false) and (this->_bodyComplete == false)
+		and (this->_output.size() <= RESP_BUF_SIZE / RESP_LOW_WATERMARK)
+		and ((this->_source->getFd() == -1) or (this->_source->isDone() == true)))		// a polled source is filled by the server
+		fillBody();
+	if (this->_output.empty() == false)
+		writtenChars = this->_output.writeTo(this->_socket, _isDirectBodyNext() ? MSG_MORE : 0);
+	else if ((this->_source != nullptr) and (this->_source->isDirect() == true))
+		writtenChars = this->_source->sendTo(this->_socket, SENDFILE_CHUNK);
 	if (writtenChars < 0)
 		throw(ServerException({"socket not available"}));
-	else if (writtenChars == 0)
-		_checkTimeout();
-	else
-	{
-		this->_contentLengthWrite += writtenChars;
-		this->_strSelf = this->_strSelf.substr(writtenChars);
-		if (this->_strSelf.empty() == true)
-			this->_state = HTTP_RESP_DONE;
-	}
+	this->_contentLengthWrite += writtenChars;
+	if ((this->_output.empty() == true) and (_isBodySent() == true))
+		this->_state = HTTP_RESP_DONE;
 }
 
 void	HTTPresponse::errorReset( int errorStatus, bool hardCode ) noexcept
 {
 	this->_statusCode = errorStatus;
+	delete this->_source;
+	this->_source = nullptr;
 	this->_HTMLfd = -1;
+	this->_cachedFile.reset();
+	this->_etag.clear();
+	this->_lastModified = -1;
+	this->_contentType.clear();
+	this->_contentEncoding = std::string_view();
+	this->_varyEncoding = false;
+	this->_serverLine = std::string_view();
+	this->_typeLine = std::string_view();
+	this->_output.clear();
+	this->_bodyLength = 0;
+	this->_bodyQueued = 0;
+	this->_bodyComplete = false;
 	this->_contentLengthWrite = 0;
+	this->_tmpBody.clear();
 	this->_targetFile.clear();
 	this->_headers.clear();
 	this->_root.clear();
 	if (hardCode == true)
 	{
 		this->_targetFile = "500.html";
-		this->_tmpBody = ERROR_500_CONTENT;
+		setBodySource(new MemorySource(ERROR_500_CONTENT));
 		this->_state = HTTP_RESP_PARSING;
 	}
 	else
-	{
-		this->_tmpBody.clear();
 		this->_state = HTTP_RESP_HTML_READING;
-	}
 	this->_type = HTTP_STATIC;
 }
 
-std::string	HTTPresponse::toString( void ) const noexcept
+// If-None-Match wins over If-Modified-Since, a match drops the body and answers 304
+bool	HTTPresponse::checkConditions( std::string_view ifNoneMatch, std::string_view ifModifiedSince )
 {
-	std::string	strResp;
-
-	strResp += this->_version.scheme;
-	strResp += "/";
-	strResp += std::to_string(this->_version.major);
-	strResp += ".";
-	strResp += std::to_string(this->_version.minor);
-	strResp += HTTP_SP;
-	strResp += std::to_string(this->_statusCode);
-	strResp += HTTP_SP;
-	strResp += this->_mapStatusCode(this->_statusCode);
-	strResp += HTTP_NL;
-	if (!this->_headers.empty())
+	std::tm	since = {};
+	bool	notModified = false;
+
+	if ((this->_statusCode != 200) or (this->_etag.empty() == true))
+		return (false);
+	if (ifNoneMatch.empty() == false)
+		notModified = _matchesETag(ifNoneMatch);
+	else if ((ifModifiedSince.empty() == false)
+		and (strptime(std::string(ifModifiedSince).c_str(), "%a, %d %b %Y %H:%M:%S GMT", &since) != nullptr))
+		notModified = (this->_lastModified <= timegm(&since));
+	if (notModified == false)
+		return (false);
+	this->_statusCode = 304;
+	delete this->_source;
+	this->_source = nullptr;
+	this->_cachedFile.reset();
+	this->_bodyLength = 0;
+	this->_bodyComplete = true;
+	return (true);
+}
+
+// Range on a static file: one range is sent as a slice of it, several as multipart/byteranges
+void	HTTPresponse::setRanges( std::string_view range, std::string_view ifRange )
+{
+	std::vector<t_Range>	ranges;
+	off_t					size = this->_bodyLength;
+	t_Range					part;
+
+	if ((range.empty() == true) or (this->_statusCode != 200) or (this->_etag.empty() == true) or (this->_source == nullptr))
+		return ;
+	if (this->_etag.compare(0, 2, "W/") == 0)		// compressed on the fly, the bytes of two responses may differ
+		return ;
+	if ((ifRange.empty() == false) and (_matchesIfRange(ifRange) == false))		// the client holds another version, it gets the whole file
+		return ;
+	if (_parseRanges(range, size, ranges) == false)		// malformed or too many ranges: ignored
+		return ;
+	this->_cachedFile.reset();		// its pre-rendered headers describe the whole file
+	if (ranges.empty() == true)
 	{
-		for (auto item : this->_headers)
-		{
-			strResp += item.first;
-			strResp += ":";
-			strResp += HTTP_SP;
-			strResp += item.second;
-			strResp += HTTP_NL;
-		}
+		this->_statusCode = 416;
+		_addHeader(HTTP_HEADER_CONT_RANGE, std::string(RANGE_UNIT) + " */" + std::to_string(size));
+		delete this->_source;
+		this->_source = nullptr;
+		this->_bodyLength = 0;
+		this->_bodyComplete = true;
+		return ;
 	}
-	strResp += HTTP_NL;
-	if (!this->_body.empty())
+	this->_statusCode = 206;
+	if (ranges.size() > 1)
+		return (_setMultipartBody(ranges, size));
+	part = ranges.front();
+	_addHeader(HTTP_HEADER_CONT_RANGE, _getContentRange(part, size));
+	setBodySource(this->_source->slice(part.first, part.second - part.first + 1));
+}
+
+// status line and headers in one allocation, the fixed lines are copied pre-rendered; the body follows from its source
+std::string	HTTPresponse::toString( void ) const noexcept
+{
+	std::string_view	status = ResponseHead::statusLine(this->_statusCode), date = ResponseHead::dateLine();
+	std::string			strResp, unknownStatus;
+	size_t				size = 0;
+
+	if (status.empty() == true)		// outside the table, sent without a reason phrase
 	{
-		strResp += this->_body;
-		strResp += HTTP_TERM;
+		unknownStatus = HTTP_DEF_VERSION + HTTP_SP + std::to_string(this->_statusCode) + HTTP_SP + HTTP_NL;
+		status = unknownStatus;
 	}
+	size = status.size() + date.size() + this->_serverLine.size() + this->_typeLine.size() + 2;
+	for (t_Header const& header : this->_headers)
+		size += header.name.size() + header.value.size() + 4;
+	if (this->_cachedFile != nullptr)
+		size += this->_cachedFile->headers.size();
+	strResp.reserve(size);
+	strResp.append(status).append(date).append(this->_serverLine).append(this->_typeLine);
+	for (t_Header const& header : this->_headers)
+		strResp.append(header.name).append(": ", 2).append(header.value).append("\r\n", 2);
+	if (this->_cachedFile != nullptr)
+		strResp.append(this->_cachedFile->headers);
+	strResp.append("\r\n", 2);
 	return (strResp);
 }
 
@@ -326,22 +414,174 @@ int		HTTPresponse::getHTMLfd( void ) const noexcept
 	return (this->_HTMLfd);
 }
 
-void	HTTPresponse::setTargetFile( path_t const& targetFile)
+// fd the server polls to fill the body, -1 when the source never has to wait
+int		HTTPresponse::getBodyFd( void ) const noexcept
+{
+	if (this->_source == nullptr)
+		return (-1);
+	return (this->_source->getFd());
+}
+
+// a small file found in the cache is sent from memory without touching the disk,
+// a larger one from the fd it shares with the other transfers of the same file
+// staticCodings: precompressed siblings the location allows, acceptedCodings: those the client takes
+void	HTTPresponse::setTargetFile( path_t const& targetFile, FileCache* cache, OpenFileCache* openFiles, uint8_t staticCodings, uint8_t acceptedCodings )
 {
+	struct stat				fileStat;
+	t_FileInfo				info;
+	OpenFileCache::file_t	file;
+	path_t					path = targetFile;		// file the bytes come from, the type stays the one of targetFile
+	int						fd = -1;
+
 	if (isStatic() == true)
 	{
-		if (this->_HTMLfd != -1)
+		if (this->_source != nullptr)
 			throw(ResponseException({"already reading file", this->_targetFile}, 500));
-		this->_HTMLfd = open(targetFile.c_str(), O_RDONLY);
-		if (this->_HTMLfd == -1)
+		this->_varyEncoding = (staticCodings != 0);
+		path = _findPrecompressed(targetFile, staticCodings & acceptedCodings, openFiles);
+		if (cache != nullptr)
+			this->_cachedFile = cache->find(path);
+		if ((this->_cachedFile == nullptr) and (openFiles != nullptr))
+		{
+			info = openFiles->getInfo(path);
+			if ((cache != nullptr) and S_ISREG(info.mode) and (cache->canHold(info.size) == true))
+				this->_cachedFile = cache->load(path, _getContTypeFromFile(targetFile));
+			if (this->_cachedFile == nullptr)
+				file = openFiles->open(path, info);
+		}
+		else if ((this->_cachedFile == nullptr) and (cache != nullptr))
+			this->_cachedFile = cache->load(path, _getContTypeFromFile(targetFile));
+		if (this->_cachedFile != nullptr)
+		{
+			setBodySource(new MemorySource(this->_cachedFile->body));
+			_setValidators(this->_cachedFile->inode, this->_cachedFile->size, this->_cachedFile->mtime);
+		}
+		else if (file != nullptr)		// sent with sendfile, nothing to poll
+		{
+			setBodySource(new FileSource(file, 0, info.size));
+			_setValidators(info.inode, info.size, info.mtime);
+		}
+		else if ((fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK)) == -1)
 			throw(ResponseException({"invalid file descriptor"}, 500));
+		else if ((fstat(fd, &fileStat) == 0) and S_ISREG(fileStat.st_mode))		// sent with sendfile, nothing to poll
+		{
+			setBodySource(new FileSource(std::make_shared<OpenFile>(fd), 0, fileStat.st_size));
+			_setValidators(fileStat.st_ino, fileStat.st_size, fileStat.st_mtim);
+		}
+		else		// fifo or device, read as the server polls it
+		{
+			this->_HTMLfd = fd;
+			setBodySource(new PipeSource(fd));
+		}
+		this->_state = HTTP_RESP_PARSING;
 	}
 	this->_targetFile = targetFile;
+	if (isStatic() == true)
+		_compressBody(this->_contentType.empty() ? _getContTypeFromFile(targetFile) : this->_contentType);
 }
 
-bool	HTTPresponse::isDoneReadingHTML( void ) const noexcept
+// .br then .gz sibling of a regular file, used when readable and not older than the file itself
+path_t	HTTPresponse::_findPrecompressed( path_t const& targetFile, uint8_t codings, OpenFileCache* openFiles )
 {
-	return (this->_state > HTTP_RESP_HTML_READING);
+	static constexpr struct { uint8_t coding; char const *suffix, *name; }	variants[] = {
+		{CODING_BR, ".br", "br"},
+		{CODING_GZIP, ".gz", "gzip"},
+	};
+	t_FileInfo	original, variant;
+	path_t		path;
+
+	if (codings == 0)
+		return (targetFile);
+	original = (openFiles != nullptr) ? openFiles->getInfo(targetFile) : OpenFileCache::readInfo(targetFile);
+	if (S_ISREG(original.mode) == false)
+		return (targetFile);
+	for (auto const& candidate : variants)
+	{
+		if ((codings & candidate.coding) == 0)
+			continue ;
+		path = targetFile;
+		path += candidate.suffix;
+		variant = (openFiles != nullptr) ? openFiles->getInfo(path) : OpenFileCache::readInfo(path);
+		if ((S_ISREG(variant.mode) == false) or ((variant.mode & (S_IRUSR | S_IRGRP | S_IROTH)) == 0))
+			continue ;
+		if ((variant.mtime.tv_sec < original.mtime.tv_sec) or ((variant.mtime.tv_sec == original.mtime.tv_sec)
+			and (variant.mtime.tv_nsec < original.mtime.tv_nsec)))		// stale, the file was edited after compressing
+			continue ;
+		this->_contentEncoding = candidate.name;
+		return (path);
+	}
+	return (targetFile);
+}
+
+// types of the server and Content-Type settings of the location, set before the target file
+void	HTTPresponse::setContentTypes( MimeTypes const* types, t_TypesConf const* conf ) noexcept
+{
+	this->_mimeTypes = types;
+	this->_typesConf = conf;
+}
+
+// gzip settings of the location, applied once the body and its type are known
+void	HTTPresponse::setCompression( t_GzipConf const* gzip, bool accepted, GzipCache* cache ) noexcept
+{
+	this->_gzip = gzip;
+	this->_gzipAccepted = accepted;
+	this->_gzipCache = cache;
+}
+
+// wraps the body in a gzip stream when the location, the type and the client allow it;
+// the variant of a static file is first looked up in the cache by path and strong validator
+GzipSource*	HTTPresponse::_compressBody( std::string const& type )
+{
+	std::string_view	mediaType(type);
+	std::string			key;
+	GzipCache::block_t	cached;
+	GzipSource			*gzip = nullptr;
+
+	if ((this->_gzip == nullptr) or (this->_gzip->enabled == false) or (this->_source == nullptr)
+		or (this->_statusCode != 200) or (this->_contentEncoding.empty() == false))
+		return (nullptr);
+	mediaType = mediaType.substr(0, mediaType.find(';'));
+	mediaType = mediaType.substr(0, mediaType.find_last_not_of(" \t") + 1);
+	if (std::none_of(this->_gzip->types.begin(), this->_gzip->types.end(), [mediaType]( std::string const& accepted ) {
+		return ((accepted == "*") or (HeaderTable::equalNames(accepted, mediaType) == true)); }))
+		return (nullptr);
+	this->_varyEncoding = true;
+	if ((this->_gzipAccepted == false)
+		or ((this->_bodyLength != -1) and (static_cast<std::uintmax_t>(this->_bodyLength) < this->_gzip->minLength)))
+		return (nullptr);
+	this->_contentEncoding = "gzip";
+	this->_cachedFile.reset();		// its pre-rendered length is the one of the file
+	if (this->_etag.empty() == false)
+	{
+		key = this->_targetFile.string() + " " + this->_etag + " " + std::to_string(this->_gzip->level);
+		this->_etag = "W/" + this->_etag;		// the same content, not the same bytes as the file
+		if ((this->_gzipCache != nullptr) and ((cached = this->_gzipCache->find(key)) != nullptr))
+			return (setBodySource(new MemorySource(cached)), nullptr);
+	}
+	gzip = new GzipSource(this->_source, this->_gzip->level, this->_bodyLength);
+	this->_source = nullptr;		// owned by the gzip stream now
+	if (key.empty() == false)
+		gzip->keepIn(this->_gzipCache, key);
+	setBodySource(gzip);
+	return (gzip);
+}
+
+void	HTTPresponse::_addEncodingHeaders( void )
+{
+	if ((this->_contentEncoding.empty() == false) and ((this->_statusCode == 200) or (this->_statusCode == 206)))
+		_addHeader(HTTP_HEADER_CONT_ENCODING, std::string(this->_contentEncoding));
+	if ((this->_varyEncoding == true) and ((this->_statusCode == 200) or (this->_statusCode == 206) or (this->_statusCode == 304)))
+		_addHeader(HTTP_HEADER_VARY, HTTP_HEADER_ACCEPT_ENCODING);
+}
+
+// takes ownership, the body length decides how the head frames it
+void	HTTPresponse::setBodySource( BodySource* source )
+{
+	delete this->_source;
+	this->_source = source;
+	this->_bodyLength = source->getLength();
+	this->_bodyQueued = 0;
+	this->_bodyComplete = (this->_bodyLength == 0);
 }
 
 bool	HTTPresponse::isParsingNeeded( void ) const noexcept
@@ -354,150 +594,372 @@ bool	HTTPresponse::isDoneWriting( void ) const noexcept
 	return (this->_state == HTTP_RESP_DONE);
 }
 
+// past this point an error can't be reported with a new response anymore
+bool	HTTPresponse::hasStartedWriting( void ) const noexcept
+{
+	return (this->_contentLengthWrite > 0);
+}
+
+// the source has nothing left for the client, its fd can go
+bool	HTTPresponse::isBodyProduced( void ) const noexcept
+{
+	return ((this->_source == nullptr) or (this->_bodyComplete == true) or (this->_source->isDone() == true));
+}
+
+// high watermark, the source waits until the client drains the buffer
+bool	HTTPresponse::isBodyBufferFull( void ) const noexcept
+{
+	return ((this->_bodyComplete == false) and (_getBodyRoom() == 0));
+}
+
+// head sent and buffer drained while a polled source is still behind
+bool	HTTPresponse::isWaitingForBody( void ) const noexcept
+{
+	return ((this->_state == HTTP_RESP_WRITING) and (isBodyProduced() == false)
+		and (this->_source->getFd() != -1) and (this->_output.empty() == true));
+}
+
+// low watermark, the source can be read again
+bool	HTTPresponse::needsBody( void ) const noexcept
+{
+	return ((isBodyProduced() == false) and (this->_output.size() <= RESP_BUF_SIZE / RESP_LOW_WATERMARK));
+}
+
+// accumulates the CGI output until its headers are complete, what follows them starts the body
+void	HTTPresponse::_readCGIhead( void )
+{
+	char					buffer[HTTP_BUF_SIZE];
+	ssize_t					readChars = 0;
+	size_t					delimiter = std::string::npos, searchFrom = 0;
+	size_t					bodyStart = 0, bodyEnd = std::string::npos;
+	BufferChain::block_t	block;
+	BufferChain				rest;
+	GzipSource				*gzip = nullptr;
+
+	while (delimiter == std::string::npos)
+	{
+		readChars = this->_source->read(buffer, HTTP_BUF_SIZE);
+		if (readChars == 0)
+			break ;
+		searchFrom = this->_tmpBody.size() - std::min(this->_tmpBody.size(), HTTP_TERM.size() - 1);		// terminator split between two reads
+		this->_tmpBody.append(buffer, readChars);
+		delimiter = ByteScan::find(this->_tmpBody, HTTP_TERM, searchFrom);
+		if ((delimiter == std::string::npos) and (this->_tmpBody.size() > CGI_HEAD_MAX))
+			throw(ResponseException({"CGI response headers too large"}, 500));
+	}
+	if (delimiter == std::string::npos)
+	{
+		if (this->_source->isDone() == true)
+			throw(ResponseException({"no headers terminator in CGI response"}, 500));
+		return ;
+	}
+	gzip = _parseCGIhead(this->_tmpBody.substr(0, delimiter + HTTP_NL.size()));
+	block = std::make_shared<std::string const>(std::move(this->_tmpBody));		// what follows the head is queued in place
+	this->_tmpBody.clear();
+	bodyStart = delimiter + HTTP_TERM.size();
+	if (gzip != nullptr)		// or deflated ahead of the rest of the output
+		return (gzip->push(std::string_view(*block).substr(bodyStart)));
+	if (this->_bodyLength != -1)
+		bodyEnd = std::min<size_t>(block->size(), bodyStart + this->_bodyLength);		// bytes past the announced length are dropped
+	rest.append(block, bodyStart, bodyEnd - bodyStart);
+	_queueBody(std::move(rest));
+}
+
+// returns the gzip stream the body now goes through, nullptr when it is sent as the CGI wrote it
+GzipSource*	HTTPresponse::_parseCGIhead( std::string const& headers )
+{
+	std::string const	*contLength = nullptr;
+	GzipSource			*gzip = nullptr;
+
+	_setVersion(HTTP_DEF_VERSION);
+	_setHeaders(headers);
+	contLength = this->_headers.find(HTTP_HEADER_CONT_LEN);
+	try {
+		this->_bodyLength = std::stoll(*contLength);
+	}
+	catch (std::exception const& e) {
+		throw(ResponseException({"invalid Content-Length in CGI response:", *contLength}, 500));
+	}
+	if (this->_bodyLength <= 0)
+		throw(ResponseException({"CGI didn't provide any body"}, 500));
+	if (this->_headers.has(HTTP_HEADER_CONT_ENCODING) == false)
+		gzip = _compressBody(*this->_headers.find(HTTP_HEADER_CONT_TYPE));
+	if (gzip != nullptr)		// the CGI's Content-Length only bounds the input of the stream now
+	{
+		this->_headers.erase(HTTP_HEADER_CONT_LEN);
+		_addHeader(HTTP_HEADER_TRANS_ENCODING, "chunked");
+	}
+	_addEncodingHeaders();
+	this->_state = HTTP_RESP_WRITING;
+	this->_output.append(toString());
+	return (gzip);
+}
+
+// bytes the source may produce now without crossing the high watermark
+size_t	HTTPresponse::_getBodyRoom( void ) const noexcept
+{
+	size_t	space = RESP_BUF_SIZE - std::min<size_t>(this->_output.size(), RESP_BUF_SIZE);
+
+	if (this->_bodyComplete == true)
+		return (0);
+	if (this->_bodyLength != -1)
+		return (std::min<size_t>({space, HTTP_BUF_SIZE, static_cast<size_t>(this->_bodyLength - this->_bodyQueued)}));
+	if (space <= CHUNK_OVERHEAD)
+		return (0);
+	return (std::min<size_t>(space - CHUNK_OVERHEAD, HTTP_BUF_SIZE));
+}
+
+// frames the bytes as one chunk when the length is unknown, the segments are moved not copied
+void	HTTPresponse::_queueBody( BufferChain&& bytes )
+{
+	static BufferChain::block_t const	chunkEnd = std::make_shared<std::string const>(HTTP_NL);
+	char								sizeLine[CHUNK_OVERHEAD];
+	char								*sizeEnd = nullptr;
+	size_t								length = bytes.size();
+
+	if (length == 0)		// a zero size chunk would end the body
+		return ;
+	if (this->_bodyLength == -1)
+	{
+		sizeEnd = std::to_chars(sizeLine, sizeLine + sizeof(sizeLine), length, 16).ptr;
+		this->_output.append(std::string(sizeLine, sizeEnd) + HTTP_NL);
+		this->_output.append(std::move(bytes));
+		this->_output.append(chunkEnd);
+	}
+	else
+		this->_output.append(std::move(bytes));
+	this->_bodyQueued += length;
+	if (this->_bodyQueued == this->_bodyLength)
+		this->_bodyComplete = true;
+}
+
+// only the head is queued and the file follows it, the kernel can hold the head back for the first file bytes
+bool	HTTPresponse::_isDirectBodyNext( void ) const noexcept
+{
+	return ((this->_source != nullptr) and (this->_source->isDirect() == true) and (this->_source->isDone() == false));
+}
+
+bool	HTTPresponse::_isBodySent( void ) const noexcept
+{
+	if (this->_source == nullptr)
+		return (true);
+	if (this->_source->isDirect() == true)
+		return (this->_source->isDone());
+	return ((this->_bodyComplete == true) and (this->_output.empty() == true));
+}
+
+// strong validator from inode, size and mtime: it changes whenever the file is replaced or written
+void	HTTPresponse::_setValidators( ino_t inode, off_t size, struct timespec const& mtime )
+{
+	char	buffer[80];
+	char	*end = buffer;
+
+	*end++ = '"';
+	end = std::to_chars(end, buffer + sizeof(buffer), mtime.tv_sec, 16).ptr;
+	*end++ = '.';
+	end = std::to_chars(end, buffer + sizeof(buffer), mtime.tv_nsec, 16).ptr;
+	*end++ = '-';
+	end = std::to_chars(end, buffer + sizeof(buffer), size, 16).ptr;
+	*end++ = '-';
+	end = std::to_chars(end, buffer + sizeof(buffer), inode, 16).ptr;
+	*end++ = '"';
+	this->_etag.assign(buffer, end);
+	this->_lastModified = mtime.tv_sec;
+}
+
+// each part is framed by its own headers, the file bytes are slices of the current source
+void	HTTPresponse::_setMultipartBody( std::vector<t_Range> const& ranges, off_t size )
+{
+	static thread_local uint64_t	sequence = static_cast<uint64_t>(std::time(nullptr)) << 20;
+	char							buffer[20];
+	std::string						boundary, type = _getContTypeFromFile(this->_targetFile);
+	SequenceSource					*body = new SequenceSource();
+
+	boundary.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), ++sequence, 16).ptr);
+	for (t_Range const& part : ranges)
+	{
+		body->append(new MemorySource(HTTP_NL + "--" + boundary + HTTP_NL + HTTP_HEADER_CONT_TYPE + ": " + type + HTTP_NL
+			+ HTTP_HEADER_CONT_RANGE + ": " + _getContentRange(part, size) + HTTP_TERM));
+		body->append(this->_source->slice(part.first, part.second - part.first + 1));
+	}
+	body->append(new MemorySource(HTTP_NL + "--" + boundary + "--" + HTTP_NL));
+	this->_contentType = "multipart/byteranges; boundary=" + boundary;
+	setBodySource(body);
+}
+
+// bytes=first-last, first- or -suffix, comma separated; false when the header must be ignored,
+// ranges left empty when none of them can be satisfied
+bool	HTTPresponse::_parseRanges( std::string_view range, off_t size, std::vector<t_Range>& ranges ) noexcept
+{
+	std::string_view	spec;
+	size_t				delim = range.find('='), dash = 0, count = 0;
+	off_t				first = 0, last = 0, suffix = 0;
+	auto				toNumber = [](std::string_view digits, off_t& value) {
+		return ((digits.empty() == false) and (std::from_chars(digits.data(), digits.data() + digits.size(), value).ptr == digits.data() + digits.size()) and (value >= 0));
+	};
+
+	if ((delim == std::string_view::npos) or (HeaderTable::equalNames(range.substr(0, delim), RANGE_UNIT) == false))
+		return (false);
+	range.remove_prefix(delim + 1);
+	while (range.empty() == false)
+	{
+		delim = std::min(range.find(','), range.size());
+		spec = range.substr(0, delim);
+		range.remove_prefix(std::min(delim + 1, range.size()));
+		spec.remove_prefix(std::min(spec.find_first_not_of(" \t"), spec.size()));
+		spec = spec.substr(0, spec.find_last_not_of(" \t") + 1);
+		if (spec.empty() == true)
+			continue ;
+		dash = spec.find('-');
+		if ((dash == std::string_view::npos) or (++count > RANGE_MAX_PARTS))
+			return (false);
+		if (dash == 0)		// last bytes of the file
+		{
+			if (toNumber(spec.substr(1), suffix) == false)
+				return (false);
+			if ((suffix == 0) or (size == 0))
+				continue ;
+			ranges.push_back({size - std::min(suffix, size), size - 1});
+			continue ;
+		}
+		if ((toNumber(spec.substr(0, dash), first) == false)
+			or ((dash + 1 < spec.size()) and (toNumber(spec.substr(dash + 1), last) == false)))
+			return (false);
+		if (dash + 1 == spec.size())
+			last = size - 1;
+		else if (last < first)
+			return (false);
+		if (first < size)
+			ranges.push_back({first, std::min(last, size - 1)});
+	}
+	return (count > 0);
+}
+
+std::string	HTTPresponse::_getContentRange( t_Range const& range, off_t size )
+{
+	return (std::string(RANGE_UNIT) + " " + std::to_string(range.first) + "-" + std::to_string(range.second) + "/" + std::to_string(size));
+}
+
+// If-Range: an entity tag must match strongly, a date must be the exact Last-Modified
+bool	HTTPresponse::_matchesIfRange( std::string_view value ) const noexcept
+{
+	std::tm	date = {};
+
+	if ((value.substr(0, 2) == "W/") or (value.front() == '"'))
+		return (value == this->_etag);
+	if (strptime(std::string(value).c_str(), "%a, %d %b %Y %H:%M:%S GMT", &date) == nullptr)
+		return (false);
+	return (timegm(&date) == this->_lastModified);
+}
+
+// weak comparison over the comma separated list, W/ is ignored on both sides
+bool	HTTPresponse::_matchesETag( std::string_view tags ) const noexcept
+{
+	std::string_view	ownTag(this->_etag), tag;
+	size_t				delim = 0;
+
+	if (ownTag.substr(0, 2) == "W/")
+		ownTag.remove_prefix(2);
+	while (tags.empty() == false)
+	{
+		delim = std::min(tags.find(','), tags.size());
+		tag = tags.substr(0, delim);
+		tags.remove_prefix(std::min(delim + 1, tags.size()));
+		tag.remove_prefix(std::min(tag.find_first_not_of(" \t"), tag.size()));
+		tag = tag.substr(0, tag.find_last_not_of(" \t") + 1);
+		if (tag.substr(0, 2) == "W/")
+			tag.remove_prefix(2);
+		if ((tag == "*") or (tag == ownTag))
+			return (true);
+	}
+	return (false);
+}
+
 void	HTTPresponse::_setHeaders( std::string const& strHeaders )
 {
-	size_t	delimiter = 0;
-	int		statusCode = -1;
+	std::string const	*status = nullptr, *location = nullptr;
+	int					statusCode = -1;
 
 	HTTPstruct::_setHeaders(strHeaders);
-	if (this->_headers.count(HTTP_HEADER_STATUS) == 0)
+	status = this->_headers.find(HTTP_HEADER_STATUS);
+	if (status == nullptr)
 		throw(ResponseException({"missing Status header in CGI response"}, 500));
-	delimiter = this->_headers.find(HTTP_HEADER_STATUS)->second.find(HTTP_SP);
 	try {
-		statusCode = std::stoi(this->_headers.find(HTTP_HEADER_STATUS)->second.substr(0, delimiter));
+		statusCode = std::stoi(status->substr(0, status->find(HTTP_SP)));
 	}
 	catch (const std::exception& e) {
-		throw(ResponseException({"invalid status code:", this->_headers.find(HTTP_HEADER_STATUS)->second}, 500));
+		throw(ResponseException({"invalid status code:", *status}, 500));
 	}
 	if (statusCode >= 400)
 		throw(ResponseException({"error while running CGI"}, statusCode));
-	if (this->_headers.find(HTTP_HEADER_SERVER) == this->_headers.end()
-		|| this->_headers.find(HTTP_HEADER_CONT_TYPE) == this->_headers.end()
-		|| this->_headers.find(HTTP_HEADER_CONT_LEN) == this->_headers.end())
+	if ((this->_headers.has(HTTP_HEADER_SERVER) == false)
+		|| (this->_headers.has(HTTP_HEADER_CONT_TYPE) == false)
+		|| (this->_headers.has(HTTP_HEADER_CONT_LEN) == false))
 	{
 		throw(ResponseException({"missing mandatory header(s) in CGI response"}, 500));
 	}
 
 	if (this->_type == HTTP_CGI_FILE_UPL)
 	{
-		if (this->_headers.count(HTTP_HEADER_LOC) == 0)
+		location = this->_headers.find(HTTP_HEADER_LOC);
+		if (location == nullptr)
 			throw(ResponseException({"missing Location header in CGI response"}, 500));
 		if (statusCode != 201)
 			throw(ResponseException({"file upload needs status code 201, given:", std::to_string(this->_statusCode)}, 500));
-		this->_targetFile = this->_headers.find(HTTP_HEADER_LOC)->second;
+		this->_targetFile = *location;
 	}
 	this->_statusCode = statusCode;
 }
 
-std::string	HTTPresponse::_mapStatusCode( int status) const
+std::string	HTTPresponse::_getDateTime( std::time_t rawtime ) const noexcept
 {
-	std::map<int, const char*> mapStatus =
-	{
-		// Information responses
-		{100, "Continue"},				// This interim response indicates that the client should continue the request or ignore the response if the request is already finished.
-		{101, "Switching Protocols"},	// This code is sent in response to an Upgrade request header from the client and indicates the protocol the server is switching to.
-		{102, "Processing"},			// This code indicates that the server has received and is processing the request, but no response is available yet.
-		{103, "Early Hints"},			// This status code is primarily intended to be used with the Link header, letting the user agent start preloading resources while the server prepares a response or preconnect to an origin from which the page will need resources.
-		// Successful responses
-		{200, "OK"},							// The request succeeded. The result meaning of "success" depends on the HTTP method
-		{201, "Created"},						// The request succeeded, and a new resource was created as a result. This is typically the response sent after POST requests, or some PUT requests.
-		{202, "Accepted"},						// The request has been received but not yet acted upon. It is noncommittal, since there is no way in HTTP to later send an asynchronous response indicating the outcome of the request. It is intended for cases where another process or server handles the request, or for batch processing.
-		{203, "Non-Authoritative Information"},	// This response code means the returned metadata is not exactly the same as is available from the origin server, but is collected from a local or a third-party copy. This is mostly used for mirrors or backups of another resource. Except for that specific case, the 200 OK response is preferred to this status.
-		{204, "No Content"},					// There is no content to send for this request, but the headers may be useful. The user agent may update its cached headers for this resource with the new ones.
-		{205, "Reset Content"},					// Tells the user agent to reset the document which sent this request.
-		{206, "Partial Content"},				// This response code is used when the Range header is sent from the client to request only part of a resource.
-		{207, "Multi-Status"},					// Conveys information about multiple resources, for situations where multiple status codes might be appropriate.
-		{208, "Already Reported"},				// Used inside a <dav:propstat> response element to avoid repeatedly enumerating the internal members of multiple bindings to the same collection.
-		{226, "IM Used"},						// The server has fulfilled a GET request for the resource, and the response is a representation of the result of one or more instance-manipulations applied to the current instance.
-		// Redirection messages
-		{300, "Multiple Choices"},		// The request has more than one possible response. The user agent or user should choose one of them. (There is no standardized way of choosing one of the responses, but HTML links to the possibilities are recommended so the user can pick.)
-		{301, "Moved Permanently"},		// The URL of the requested resource has been changed permanently. The new URL is given in the response.
-		{302, "Found"},					// This response code means that the URI of requested resource has been changed temporarily. Further changes in the URI might be made in the future. Therefore, this same URI should be used by the client in future requests.
-		{303, "See Other"},				// The server sent this response to direct the client to get the requested resource at another URI with a GET request.
-		{304, "Not Modified"},			// This is used for caching purposes. It tells the client that the response has not been modified, so the client can continue to use the same cached version of the response.
-		{305, "Use Proxy"},				// Defined in a previous version of the HTTP specification to indicate that a requested response must be accessed by a proxy. It has been deprecated due to security concerns regarding in-band configuration of a proxy.
-		{306, "unused"},				// This response code is no longer used; it is just reserved. It was used in a previous version of the HTTP/1.1 specification.
-		{307, "Temporary Redirect"},	// The server sends this response to direct the client to get the requested resource at another URI with the same method that was used in the prior request. This has the same semantics as the 302 Found HTTP response code, with the exception that the user agent must not change the HTTP method used: if a POST was used in the first request, a POST must be used in the second request.
-		{308, "Permanent Redirect"},	// This means that the resource is now permanently located at another URI, specified by the Location: HTTP Response header. This has the same semantics as the 301 Moved Permanently HTTP response code, with the exception that the user agent must not change the HTTP method used: if a POST was used in the first request, a POST must be used in the second request.
-		// Client error responses
-		{400, "Bad Request"},						// The server cannot or will not process the request due to something that is perceived to be a client error (e.g., malformed request syntax, invalid request message framing, or deceptive request routing).
-		{401, "Unauthorized"},						// Although the HTTP standard specifies "unauthorized", semantically this response means "unauthenticated". That is, the client must authenticate itself to get the requested response.
-		{402, "Payment Required"},					// This response code is reserved for future use. The initial aim for creating this code was using it for digital payment systems, however this status code is used very rarely and no standard convention exists.
-		{403, "Forbidden"},							// The client does not have access rights to the content; that is, it is unauthorized, so the server is refusing to give the requested resource. Unlike 401 Unauthorized, the client's identity is known to the server.
-		{404, "Not Found"},							// The server cannot find the requested resource. In the browser, this means the URL is not recognized. In an API, this can also mean that the endpoint is valid but the resource itself does not exist. Servers may also send this response instead of 403 Forbidden to hide the existence of a resource from an unauthorized client. This response code is probably the most well known due to its frequent occurrence on the web.
-		{405, "Method Not Allowed"},				// The request method is known by the server but is not supported by the target resource. For example, an API may not allow calling DELETE to remove a resource.
-		{406, "Not Acceptable"},					// This response is sent when the web server, after performing server-driven content negotiation, doesn't find any content that conforms to the criteria given by the user agent.
-		{407, "Proxy Authentication Required"},		// This is similar to 401 Unauthorized but authentication is needed to be done by a proxy.
-		{408, "Request Timeout"},					// This response is sent on an idle connection by some servers, even without any previous request by the client. It means that the server would like to shut down this unused connection. This response is used much more since some browsers, like Chrome, Firefox 27+, or IE9, use HTTP pre-connection mechanisms to speed up surfing. Also note that some servers merely shut down the connection without sending this message.
-		{409, "Conflict"},							// This response is sent when a request conflicts with the current state of the server.
-		{410, "Gone"},								// This response is sent when the requested content has been permanently deleted from server, with no forwarding address. Clients are expected to remove their caches and links to the resource. The HTTP specification intends this status code to be used for "limited-time, promotional services". APIs should not feel compelled to indicate resources that have been deleted with this status code.
-		{411, "Length Required"},					// Server rejected the request because the Content-Length header field is not defined and the server requires it.
-		{412, "Precondition Failed"},				// The client has indicated preconditions in its headers which the server does not meet.
-		{413, "Payload Too Large"},					// Request entity is larger than limits defined by server. The server might close the connection or return an Retry-After header field.
-		{414, "URI Too Long"},						// The URI requested by the client is longer than the server is willing to interpret.
-		{415, "Unsupported Media Type"},			// The media format of the requested data is not supported by the server, so the server is rejecting the request.
-		{416, "Range Not Satisfiable"},				// The range specified by the Range header field in the request cannot be fulfilled. It's possible that the range is outside the size of the target URI's data.
-		{417, "Expectation Failed"},				// This response code means the expectation indicated by the Expect request header field cannot be met by the server.
-		{418, "I'm a teapot"},						// The server refuses the attempt to brew coffee with a teapot.
-		{421, "Misdirected Request"},				// The request was directed at a server that is not able to produce a response. This can be sent by a server that is not configured to produce responses for the combination of scheme and authority that are included in the request URI.
-		{422, "Unprocessable Content"},				// The request was well-formed but was unable to be followed due to semantic errors.
-		{423, "Locked"},							// The resource that is being accessed is locked.
-		{424, "Failed Dependency"},					// The request failed due to failure of a previous request.
-		{425, "Too Early"},							// Indicates that the server is unwilling to risk processing a request that might be replayed.
-		{426, "Upgrade Required"},					// The server refuses to perform the request using the current protocol but might be willing to do so after the client upgrades to a different protocol. The server sends an Upgrade header in a 426 response to indicate the required protocol(s).
-		{428, "Precondition Required"},				// The origin server requires the request to be conditional. This response is intended to prevent the 'lost update' problem, where a client GETs a resource's state, modifies it and PUTs it back to the server, when meanwhile a third party has modified the state on the server, leading to a conflict.
-		{429, "Too Many Requests"},					// The user has sent too many requests in a given amount of time ("rate limiting").
-		{431, "Request Header Fields Too Large"},	// The server is unwilling to process the request because its header fields are too large. The request may be resubmitted after reducing the size of the request header fields.
-		{451, "Unavailable For Legal Reasons"},		// The user agent requested a resource that cannot legally be provided, such as a web page censored by a government.
-		// Server error responses
-		{500, "Internal Server Error"},				// The server has encountered a situation it does not know how to handle.
-		{501, "Not Implemented"},					// The request method is not supported by the server and cannot be handled. The only methods that servers are required to support (and therefore that must not return this code) are GET and HEAD.
-		{502, "Bad Gateway"},						// This error response means that the server, while working as a gateway to get a response needed to handle the request, got an invalid response.
-		{503, "Service Unavailable"},				// The server is not ready to handle the request. Common causes are a server that is down for maintenance or that is overloaded. Note that together with this response, a user-friendly page explaining the problem should be sent. This response should be used for temporary conditions and the Retry-After HTTP header should, if possible, contain the estimated time before the recovery of the service. The webmaster must also take care about the caching-related headers that are sent along with this response, as these temporary condition responses should usually not be cached.
-		{504, "Gateway Timeout"},					// This error response is given when the server is acting as a gateway and cannot get a response in time.
-		{505, "HTTP Version Not Supported"},		// The HTTP version used in the request is not supported by the server.
-		{506, "Variant Also Negotiates"},			// The server has an internal configuration error: the chosen variant resource is configured to engage in transparent content negotiation itself, and is therefore not a proper end point in the negotiation process.
-		{507, "Insufficient Storage"},				// The method could not be performed on the resource because the server is unable to store the representation needed to successfully complete the request.
-		{508, "Loop Detected"},						// The server detected an infinite loop while processing the request.
-		{510, "Not Extended"},						// Further extensions to the request are required for the server to fulfill it.
-		{511, "Network Authentication Required"},	// Indicates that the client needs to authenticate to gain network access.
-	};
+	std::tm timeinfo;
+	char buffer[80];
 
-	try
-	{
-		return (std::string(mapStatus.at(status)));
-	}
-	catch(const std::out_of_range& e) {
-		throw(ResponseException({"Unknown HTTP response code:", std::to_string(status)}, 500));
-	}
+	gmtime_r(&rawtime, &timeinfo);
+	std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &timeinfo);
+	return (std::string(buffer));
 }
 
-std::string	HTTPresponse::_getDateTime( void ) const noexcept
+// media type with the location's charset when it applies
+std::string	HTTPresponse::_getContTypeFromFile( path_t const& fileName ) const noexcept
 {
-	std::time_t rawtime;
-	std::tm* timeinfo;
-	char buffer[80];
+	t_MimeType const&	mime = _findType(fileName);
 
-	std::time(&rawtime);
-	timeinfo = std::gmtime(&rawtime);
-	std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", timeinfo);
-	return (std::string(buffer));
+	if (_takesCharset(mime.type) == true)
+		return (mime.type + "; charset=" + this->_typesConf->charset);
+	return (mime.type);
 }
 
-std::string	HTTPresponse::_getContTypeFromFile( path_t const& fileName) const noexcept
-{
-	if ((fileName.extension() == ".html") or isAutoIndex())
-		return (HTML_CONTENT_TYPE);
-	else if (fileName.extension() == ".css")
-		return (CSS_CONTENT_TYPE);
-	else if (fileName.extension() == ".js")
-		return (JS_CONTENT_TYPE);
-	else if ((fileName.extension() == ".jpg") or (fileName.extension() == ".jpeg"))
-		return (JPG_CONTENT_TYPE);
-	else if (fileName.extension() == ".png")
-		return (PNG_CONTENT_TYPE);
-	else if (fileName.extension() == ".ico")
-		return (ICO_CONTENT_TYPE);
-	else
-		return (PLAIN_CONTENT_TYPE);
+// pre-rendered line of the type, empty when a charset has to be added
+std::string_view	HTTPresponse::_getContTypeLine( path_t const& fileName ) const noexcept
+{
+	t_MimeType const&	mime = _findType(fileName);
+
+	if (_takesCharset(mime.type) == true)
+		return (std::string_view());
+	return (mime.line);
+}
+
+// one probe in the registry by extension, the location's default_type when unknown
+t_MimeType const&	HTTPresponse::_findType( path_t const& fileName ) const noexcept
+{
+	static t_MimeType const	listing = MimeTypes::render(LISTING_CONTENT_TYPE), fallback = MimeTypes::render(DEF_DEFAULT_TYPE);
+	MimeTypes const&		types = (this->_mimeTypes != nullptr) ? *this->_mimeTypes : MimeTypes::builtin();
+	std::string const		extension = fileName.extension().string();
+	t_MimeType const		*found = nullptr;
+
+	if (isAutoIndex() == true)
+		return (listing);
+	if (extension.size() > 1)
+		found = types.find(std::string_view(extension).substr(1));
+	if (found != nullptr)
+		return (*found);
+	return ((this->_typesConf != nullptr) ? this->_typesConf->defaultType : fallback);
+}
+
+bool	HTTPresponse::_takesCharset( std::string const& type ) const noexcept
+{
+	return ((this->_typesConf != nullptr) and (this->_typesConf->charset.empty() == false)
+		and (MimeTypes::takesCharset(type) == true));
 }
@@ -72,22 +72,17 @@ bool	HTTPstruct::isCGI( void ) const noexcept
 
 void	HTTPstruct::_setHeaders( std::string const& headers )
 {
-	size_t 		nextHeader, delimHeader;
-	std::string key, value, tmpHeaders=headers;
+	std::string_view	line;
+	size_t 				lineStart = 0, nextHeader = 0, delimHeader = 0;
 
-	if (tmpHeaders.empty())
-		return ;
-	nextHeader = tmpHeaders.find(HTTP_NL);
-	while (nextHeader != std::string::npos)
+	while ((nextHeader = ByteScan::find(headers, HTTP_NL, lineStart)) != std::string::npos)
 	{
-		delimHeader = tmpHeaders.find(": ");
+		line = std::string_view(headers).substr(lineStart, nextHeader - lineStart);
+		delimHeader = ByteScan::find(line, ": ");
 		if (delimHeader == std::string::npos)
-			throw(HTTPexception({"invalid header format:", tmpHeaders.substr(0, nextHeader)}, 400));
-		key = tmpHeaders.substr(0, delimHeader);
-		value = tmpHeaders.substr(delimHeader + 2, nextHeader - delimHeader - 2);
-		tmpHeaders = tmpHeaders.substr(nextHeader + HTTP_NL.size());
-		_addHeader(key, value);
-		nextHeader = tmpHeaders.find(HTTP_NL);
+			throw(HTTPexception({"invalid header format:", std::string(line)}, 400));
+		_addHeader(std::string(line.substr(0, delimHeader)), std::string(line.substr(delimHeader + 2)));
+		lineStart = nextHeader + HTTP_NL.size();
 	}
 }
 
@@ -126,21 +121,7 @@ void	HTTPstruct::_setVersion( std::string const& strVersion )
 	this->_version.minor = minor;
 }
 
-void	HTTPstruct::_resetTimeout( void ) noexcept
+void	HTTPstruct::_addHeader(std::string const& name, std::string const& content)
 {
-	this->_lastActivity = steady_clock::now();
-}
-
-void	HTTPstruct::_checkTimeout( void )
-{
-	duration<double> 	time_span;
-
-	time_span = duration_cast<duration<int>>(steady_clock::now() - this->_lastActivity);
-	if (time_span.count() > HTTP_MAX_TIMEOUT)
-		throw(RequestException({"timeout request"}, 408));
-}
-
-void	HTTPstruct::_addHeader(std::string const& name, std::string const& content) noexcept
-{
-	this->_headers.insert({name, content});
+	this->_headers.add(name, content);
 }
@@ -0,0 +1,55 @@
+#include "HeaderTable.hpp"
+
+void	HeaderTable::add( std::string const& name, std::string const& value )
+{
+	if (this->_fields.capacity() == 0)
+		this->_fields.reserve(HEADER_TABLE_RESERVE);
+	this->_fields.push_back({name, value});
+}
+
+void	HeaderTable::clear( void ) noexcept
+{
+	this->_fields.clear();
+}
+
+// every field with that name
+void	HeaderTable::erase( std::string_view name ) noexcept
+{
+	this->_fields.erase(std::remove_if(this->_fields.begin(), this->_fields.end(),
+		[name]( t_Header const& field ) { return (equalNames(field.name, name)); }), this->_fields.end());
+}
+
+bool	HeaderTable::has( std::string_view name ) const noexcept
+{
+	return (find(name) != nullptr);
+}
+
+std::string const*	HeaderTable::find( std::string_view name ) const noexcept
+{
+	for (t_Header const& field : this->_fields)
+	{
+		if (equalNames(field.name, name) == true)
+			return (&field.value);
+	}
+	return (nullptr);
+}
+
+bool	HeaderTable::empty( void ) const noexcept
+{
+	return (this->_fields.empty());
+}
+
+std::vector<t_Header>::const_iterator	HeaderTable::begin( void ) const noexcept
+{
+	return (this->_fields.begin());
+}
+
+std::vector<t_Header>::const_iterator	HeaderTable::end( void ) const noexcept
+{
+	return (this->_fields.end());
+}
+
+bool	HeaderTable::equalNames( std::string_view name1, std::string_view name2 ) noexcept
+{
+	return ((name1.size() == name2.size()) and (strncasecmp(name1.data(), name2.data(), name1.size()) == 0));
+}
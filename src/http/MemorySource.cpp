@@ -0,0 +1,34 @@
+#include "MemorySource.hpp"
+
+ssize_t	MemorySource::read( char* buffer, size_t length )
+{
+	size_t	toCopy = std::min(length, this->_end - this->_pos);
+
+	memcpy(buffer, this->_bytes->data() + this->_pos, toCopy);
+	this->_pos += toCopy;
+	return (toCopy);
+}
+
+size_t	MemorySource::readInto( BufferChain& chain, size_t length )
+{
+	size_t	toShare = std::min(length, this->_end - this->_pos);
+
+	chain.append(this->_bytes, this->_pos, toShare);
+	this->_pos += toShare;
+	return (toShare);
+}
+
+bool	MemorySource::isDone( void ) const noexcept
+{
+	return (this->_pos == this->_end);
+}
+
+off_t	MemorySource::getLength( void ) const noexcept
+{
+	return (this->_end - this->_pos);
+}
+
+BodySource*	MemorySource::slice( off_t offset, off_t length ) const
+{
+	return (new MemorySource(this->_bytes, this->_pos + offset, length));
+}
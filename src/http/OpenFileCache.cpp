@@ -0,0 +1,139 @@
+#include "OpenFileCache.hpp"
+
+t_FileInfo	OpenFileCache::getInfo( path_t const& path )
+{
+	t_Entry	*entry = nullptr;
+
+	if (isEnabled() == false)
+		return (readInfo(path));
+	entry = _lookup(path);
+	if (entry == nullptr)
+		return (t_FileInfo{});
+	return (entry->info);
+}
+
+// shared fd of a regular file, nullptr for anything else; info is refreshed along with it
+OpenFileCache::file_t	OpenFileCache::open( path_t const& path, t_FileInfo& info )
+{
+	t_Entry	*entry = nullptr;
+
+	if (isEnabled() == false)
+	{
+		info = readInfo(path);
+		return (S_ISREG(info.mode) ? openFile(path) : nullptr);
+	}
+	entry = _lookup(path);
+	if (entry == nullptr)
+	{
+		info = t_FileInfo{};
+		return (nullptr);
+	}
+	info = entry->info;
+	if ((entry->file == nullptr) and S_ISREG(info.mode))
+		entry->file = openFile(path);
+	return (S_ISREG(info.mode) ? entry->file : nullptr);
+}
+
+// the server changed the file itself (DELETE), it may be held under its canonical path or the one it was looked up with
+void	OpenFileCache::forget( path_t const& path ) noexcept
+{
+	for (auto it = this->_entries.begin(); it != this->_entries.end(); )
+	{
+		auto	next = std::next(it);
+
+		if ((it->first == path.string()) or (it->second.info.realPath == path))
+			_erase(it);
+		it = next;
+	}
+}
+
+bool	OpenFileCache::isEnabled( void ) const noexcept
+{
+	return (this->_maxEntries > 0);
+}
+
+// one stat, the canonical form is only resolved for paths that exist
+t_FileInfo	OpenFileCache::readInfo( path_t const& path )
+{
+	t_FileInfo	info = {};
+	struct stat	fileStat;
+
+	info.exists = (stat(path.c_str(), &fileStat) == 0);
+	if (info.exists == false)
+		return (info);
+	info.mode = fileStat.st_mode;
+	info.size = fileStat.st_size;
+	info.device = fileStat.st_dev;
+	info.inode = fileStat.st_ino;
+	info.mtime = fileStat.st_mtim;
+	info.realPath = std::filesystem::weakly_canonical(path);
+	return (info);
+}
+
+OpenFileCache::file_t	OpenFileCache::openFile( path_t const& path ) noexcept
+{
+	int	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+
+	if (fd == -1)
+		return (nullptr);
+	return (std::make_shared<OpenFile>(fd));
+}
+
+// a stale entry is checked with one stat, its fd is dropped when the file was replaced or changed
+OpenFileCache::t_Entry*	OpenFileCache::_lookup( path_t const& path )
+{
+	std::time_t	now = std::time(nullptr);
+	auto		it = this->_entries.find(path.string());
+	t_FileInfo	fresh;
+
+	_expire(now);
+	if (it == this->_entries.end())
+	{
+		fresh = readInfo(path);
+		if (fresh.exists == false)
+			return (nullptr);
+		while (this->_entries.size() >= this->_maxEntries)
+			_erase(this->_entries.find(this->_lru.back()));
+		this->_lru.push_front(path.string());
+		it = this->_entries.emplace(path.string(), t_Entry{fresh, nullptr, now, now, this->_lru.begin()}).first;
+		return (&it->second);
+	}
+	if (now - it->second.checkedAt >= this->_valid)
+	{
+		fresh = readInfo(path);
+		if (fresh.exists == false)
+		{
+			_erase(it);
+			return (nullptr);
+		}
+		if (_isSameFile(it->second.info, fresh) == false)
+		{
+			it->second.info = fresh;
+			it->second.file.reset();
+		}
+		it->second.checkedAt = now;
+	}
+	it->second.usedAt = now;
+	this->_lru.splice(this->_lru.begin(), this->_lru, it->second.lru);
+	return (&it->second);
+}
+
+// least recently used entries are at the back, the first one still in use ends the sweep
+void	OpenFileCache::_expire( std::time_t now ) noexcept
+{
+	while ((this->_lru.empty() == false) and (now - this->_entries.find(this->_lru.back())->second.usedAt >= this->_inactive))
+		_erase(this->_entries.find(this->_lru.back()));
+}
+
+void	OpenFileCache::_erase( std::unordered_map<std::string, t_Entry>::iterator it ) noexcept
+{
+	this->_lru.erase(it->second.lru);
+	this->_entries.erase(it);
+}
+
+bool	OpenFileCache::_isSameFile( t_FileInfo const& cached, t_FileInfo const& fresh ) noexcept
+{
+	return ((cached.mode == fresh.mode) and (cached.device == fresh.device) and (cached.inode == fresh.inode)
+		and (cached.size == fresh.size) and (cached.mtime.tv_sec == fresh.mtime.tv_sec)
+		and (cached.mtime.tv_nsec == fresh.mtime.tv_nsec));
+}
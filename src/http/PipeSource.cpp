@@ -0,0 +1,29 @@
+#include "PipeSource.hpp"
+
+ssize_t	PipeSource::read( char* buffer, size_t length )
+{
+	ssize_t	readChars = -1;
+
+	if (this->_done == true)		// the fd may already be closed
+		return (0);
+	readChars = ::read(this->_fd, buffer, length);
+	if (readChars < 0)
+	{
+		if ((errno == EAGAIN) or (errno == EWOULDBLOCK))
+			return (0);
+		throw(ResponseException({"body source not available:", strerror(errno)}, 500));
+	}
+	if (readChars == 0)
+		this->_done = true;
+	return (readChars);
+}
+
+bool	PipeSource::isDone( void ) const noexcept
+{
+	return (this->_done);
+}
+
+int		PipeSource::getFd( void ) const noexcept
+{
+	return (this->_fd);
+}
@@ -0,0 +1,184 @@
+#include "RequestParser.hpp"
+
+static constexpr std::string_view	knownHeaders[HDR_KNOWN_COUNT] =
+{
+	"Host",
+	"Content-Length",
+	"Content-Type",
+	"Connection",
+	"Transfer-Encoding",
+	"Cookie",
+	"If-None-Match",
+	"If-Modified-Since",
+	"Range",
+	"If-Range",
+	"Accept-Encoding",
+};
+
+RequestParser::RequestParser( void ) noexcept
+{
+	reset();
+}
+
+// scans only the bytes not seen yet, buffer must keep the bytes of the previous calls at the same address
+bool	RequestParser::feed( char const* buffer, size_t length )
+{
+	char const	*newLine = nullptr;
+	size_t		lineEnd = 0;
+
+	while ((this->_state != PARSE_DONE) and (this->_pos < length))
+	{
+		newLine = ByteScan::find(buffer + this->_pos, length - this->_pos, '\n');
+		if (newLine == nullptr)
+		{
+			this->_pos = length;
+			break ;
+		}
+		this->_pos = newLine - buffer + 1;
+		lineEnd = newLine - buffer;
+		if ((lineEnd > this->_lineStart) and (buffer[lineEnd - 1] == '\r'))
+			lineEnd--;
+		std::string_view	line(buffer + this->_lineStart, lineEnd - this->_lineStart);
+		this->_lineStart = this->_pos;
+		if (this->_state == PARSE_REQ_LINE)
+		{
+			if (line.empty() == false)		// empty lines before the request line are ignored
+				_parseRequestLine(line);
+		}
+		else if (line.empty() == true)
+			this->_state = PARSE_DONE;
+		else
+			_parseHeaderLine(line);
+	}
+	return (this->_state == PARSE_DONE);
+}
+
+void	RequestParser::reset( void ) noexcept
+{
+	this->_state = PARSE_REQ_LINE;
+	this->_pos = 0;
+	this->_lineStart = 0;
+	this->_method = std::string_view();
+	this->_target = std::string_view();
+	this->_version = std::string_view();
+	this->_nHeaders = 0;
+	this->_known.fill(-1);
+}
+
+bool	RequestParser::isDone( void ) const noexcept
+{
+	return (this->_state == PARSE_DONE);
+}
+
+size_t	RequestParser::getHeadSize( void ) const noexcept
+{
+	return (this->_pos);
+}
+
+std::string_view	RequestParser::getMethod( void ) const noexcept
+{
+	return (this->_method);
+}
+
+std::string_view	RequestParser::getTarget( void ) const noexcept
+{
+	return (this->_target);
+}
+
+std::string_view	RequestParser::getVersion( void ) const noexcept
+{
+	return (this->_version);
+}
+
+bool	RequestParser::hasHeader( HeaderId id ) const noexcept
+{
+	return (this->_known[id] != -1);
+}
+
+std::string_view	RequestParser::getHeader( HeaderId id ) const noexcept
+{
+	if (this->_known[id] == -1)
+		return (std::string_view());
+	return (this->_headers[this->_known[id]].value);
+}
+
+bool	RequestParser::hasHeader( std::string_view name ) const noexcept
+{
+	for (size_t i = 0; i < this->_nHeaders; i++)
+	{
+		if (HeaderTable::equalNames(this->_headers[i].name, name) == true)
+			return (true);
+	}
+	return (false);
+}
+
+std::string_view	RequestParser::getHeader( std::string_view name ) const noexcept
+{
+	for (size_t i = 0; i < this->_nHeaders; i++)
+	{
+		if (HeaderTable::equalNames(this->_headers[i].name, name) == true)
+			return (this->_headers[i].value);
+	}
+	return (std::string_view());
+}
+
+size_t	RequestParser::getHeadersCount( void ) const noexcept
+{
+	return (this->_nHeaders);
+}
+
+t_HeaderView const&	RequestParser::getHeaderAt( size_t index ) const noexcept
+{
+	return (this->_headers[index]);
+}
+
+void	RequestParser::_parseRequestLine( std::string_view line )
+{
+	size_t	firstSP = line.find(' ');
+	size_t	lastSP = line.rfind(' ');
+
+	if ((firstSP == std::string_view::npos) or (firstSP == lastSP) or (firstSP == 0) or
+		(lastSP == line.size() - 1) or (line.find(' ', firstSP + 1) != lastSP))
+		throw(RequestException({"invalid request line:", std::string(line)}, 400));
+	this->_method = line.substr(0, firstSP);
+	this->_target = line.substr(firstSP + 1, lastSP - firstSP - 1);
+	this->_version = line.substr(lastSP + 1);
+	this->_state = PARSE_HEADER_LINE;
+}
+
+void	RequestParser::_parseHeaderLine( std::string_view line )
+{
+	size_t	colon = ByteScan::find(line, ':');
+
+	if ((line.front() == ' ') or (line.front() == '\t'))		// obsolete line folding
+		throw(RequestException({"folded header line:", std::string(line)}, 400));
+	if ((colon == std::string_view::npos) or (colon == 0))
+		throw(RequestException({"invalid header format:", std::string(line)}, 400));
+	if (line.substr(0, colon).find_first_of(" \t") != std::string_view::npos)
+		throw(RequestException({"whitespace in header name:", std::string(line)}, 400));
+	if (this->_nHeaders == HTTP_MAX_HEADERS)
+		throw(RequestException({"too many headers"}, 431));
+	this->_headers[this->_nHeaders].name = line.substr(0, colon);
+	this->_headers[this->_nHeaders].value = _trimOWS(line.substr(colon + 1));
+	for (int id = 0; id < HDR_KNOWN_COUNT; id++)
+	{
+		if (HeaderTable::equalNames(knownHeaders[id], this->_headers[this->_nHeaders].name) == false)
+			continue ;
+		if ((this->_known[id] != -1) and ((id == HDR_HOST) or (id == HDR_CONT_LEN)))		// ambiguous framing or target
+			throw(RequestException({"duplicate header:", std::string(knownHeaders[id])}, 400));
+		if (this->_known[id] == -1)
+			this->_known[id] = this->_nHeaders;
+		break ;
+	}
+	this->_nHeaders++;
+}
+
+std::string_view	RequestParser::_trimOWS( std::string_view value ) noexcept
+{
+	size_t	start = value.find_first_not_of(" \t");
+	size_t	end = value.find_last_not_of(" \t");
+
+	if (start == std::string_view::npos)
+		return (std::string_view());
+	return (value.substr(start, end - start + 1));
+}
@@ -0,0 +1,67 @@
+#include "RingBuffer.hpp"
+
+// storage is allocated once, the capacity never changes afterwards
+void	RingBuffer::reserve( size_t capacity )
+{
+	if (this->_data.empty() == true)
+		this->_data.resize(capacity);
+}
+
+// copies as much as fits, returns the number of bytes taken
+size_t	RingBuffer::push( char const* bytes, size_t length ) noexcept
+{
+	size_t	toCopy = std::min(length, space());
+	size_t	end = 0, firstPart = 0;
+
+	if (toCopy == 0)
+		return (0);
+	end = (this->_start + this->_size) % this->_data.size();
+	firstPart = std::min(toCopy, this->_data.size() - end);
+	memcpy(this->_data.data() + end, bytes, firstPart);
+	memcpy(this->_data.data(), bytes + firstPart, toCopy - firstPart);
+	this->_size += toCopy;
+	return (toCopy);
+}
+
+// one writev for both parts of the queue, returns 0 when fd can't take anything now and -1 on error
+ssize_t	RingBuffer::writeTo( int fd ) noexcept
+{
+	struct iovec	parts[2];
+	size_t			firstPart = std::min(this->_size, this->_data.size() - this->_start);
+	ssize_t			written = -1;
+
+	if (this->_size == 0)
+		return (0);
+	parts[0].iov_base = this->_data.data() + this->_start;
+	parts[0].iov_len = firstPart;
+	parts[1].iov_base = this->_data.data();
+	parts[1].iov_len = this->_size - firstPart;
+	written = writev(fd, parts, (parts[1].iov_len == 0) ? 1 : 2);
+	if (written < 0)
+		return (((errno == EAGAIN) or (errno == EWOULDBLOCK)) ? 0 : -1);
+	this->_start = (this->_start + written) % this->_data.size();
+	this->_size -= written;
+	if (this->_size == 0)
+		this->_start = 0;
+	return (written);
+}
+
+size_t	RingBuffer::size( void ) const noexcept
+{
+	return (this->_size);
+}
+
+size_t	RingBuffer::space( void ) const noexcept
+{
+	return (this->_data.size() - this->_size);
+}
+
+bool	RingBuffer::empty( void ) const noexcept
+{
+	return (this->_size == 0);
+}
+
+bool	RingBuffer::full( void ) const noexcept
+{
+	return (this->_size == this->_data.size());
+}
@@ -0,0 +1,67 @@
+#include "SequenceSource.hpp"
+
+SequenceSource::~SequenceSource( void )
+{
+	for (BodySource* part : this->_parts)
+		delete part;
+}
+
+// every part must know its length and never wait (memory or file)
+void	SequenceSource::append( BodySource* part )
+{
+	this->_parts.push_back(part);
+}
+
+ssize_t	SequenceSource::read( char* buffer, size_t length )
+{
+	ssize_t	readChars = 0, total = 0;
+
+	for (_skipDone(); (this->_current < this->_parts.size()) and (static_cast<size_t>(total) < length); _skipDone())
+	{
+		readChars = this->_parts[this->_current]->read(buffer + total, length - total);
+		if (readChars == 0)
+			break ;
+		total += readChars;
+	}
+	return (total);
+}
+
+// parts are asked one by one so a memory part still shares its block
+size_t	SequenceSource::readInto( BufferChain& chain, size_t length )
+{
+	size_t	readChars = 0, total = 0;
+
+	for (_skipDone(); (this->_current < this->_parts.size()) and (total < length); _skipDone())
+	{
+		readChars = this->_parts[this->_current]->readInto(chain, length - total);
+		if (readChars == 0)
+			break ;
+		total += readChars;
+	}
+	return (total);
+}
+
+bool	SequenceSource::isDone( void ) const noexcept
+{
+	for (size_t i = this->_current; i < this->_parts.size(); i++)
+	{
+		if (this->_parts[i]->isDone() == false)
+			return (false);
+	}
+	return (true);
+}
+
+off_t	SequenceSource::getLength( void ) const noexcept
+{
+	off_t	total = 0;
+
+	for (size_t i = this->_current; i < this->_parts.size(); i++)
+		total += this->_parts[i]->getLength();
+	return (total);
+}
+
+void	SequenceSource::_skipDone( void ) noexcept
+{
+	while ((this->_current < this->_parts.size()) and (this->_parts[this->_current]->isDone() == true))
+		this->_current++;
+}
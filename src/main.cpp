@@ -1,63 +1,134 @@
-#include "Tokenizer.hpp"
-#include "WebServer.hpp"
-
-std::vector<Config>	parseServers(std::string const& fileName)
-{
-	Tokenizer *config;
-	config = new Tokenizer();
-	std::vector<Config> servers;
-	try {
-		config->fillConfig(fileName);
-	}
-	catch(const std::exception& e) {
-		std::cerr << e.what() << '\n';
-		delete config;
-		return (servers);
-	}
-	std::vector<std::vector<std::string>> separated = config->divideContent();
-	delete config;
-	for (size_t i = 0; i < separated.size(); i++)
-	{
-		Config tmp;
-		try {
-			tmp.parseBlock(separated[i]);
-			servers.push_back(tmp);
-		}
-		catch(const std::exception& e) {
-			std::cerr << "Failure on Server index " C_RED << i << C_RESET "\n";
-			std::cerr << C_RED << e.what() << C_RESET "\n";
-			std::cerr << C_YELLOW "Continuing with parsing other servers...\n" C_RESET;
-		}
-	}
-	return (servers);
-}
-
-int main(int ac, char **av)
-{
-	std::vector<Config> servers;
-	if (ac > 2)
-	{
-		std::cerr << C_RED "Wrong amount of arguments - valid usage: ./" << av[0] << " [config_file_path]\n";
-		return (EXIT_FAILURE);
-	}
-	else if (ac == 2)	// custom configuration
-	{
-		std::cout << "Using config: " << C_GREEN << av[1] << C_RESET << "\n";
-		servers = parseServers(av[1]);
-	}
-	else				// default configuration
-	{
-		std::cout << "No argument provided, using default config: " C_GREEN << DEF_CONF_PATH << C_RESET << "\n";
-		servers = parseServers(DEF_CONF_PATH);
-	}
-	try
-	{
-		WebServer	webserv(servers);
-		webserv.run();
-	}
-	catch(const WebservException& e) {
-		std::cerr << e.what() << '\n';
-		return (EXIT_FAILURE);
-	}
-	return (EXIT_SUCCESS);
-}
+#include "Tokenizer.hpp"
+#include "WebServer.hpp"
+#include <thread>
+#include <atomic>
+#include <pthread.h>	// pthread_setaffinity_np
+
+std::vector<Config>	parseServers(std::string const& fileName, Events& events, MimeTypes& types)
+{
+	Tokenizer *config;
+	config = new Tokenizer();
+	std::vector<Config> servers;
+	try {
+		config->fillConfig(fileName);
+	}
+	catch(const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		delete config;
+		return (servers);
+	}
+	std::vector<std::vector<std::string>> separated = config->divideContent();
+	delete config;
+	for (size_t i = 0; i < separated.size(); i++)
+	{
+		if (separated[i].front() == "events")
+		{
+			try {
+				events.parseBlock(separated[i]);
+			}
+			catch(const std::exception& e) {
+				std::cerr << C_RED << e.what() << C_RESET "\n";
+				std::cerr << C_YELLOW "Using default events settings...\n" C_RESET;
+				events = Events();
+			}
+			continue ;
+		}
+		if (separated[i].front() == "types")
+		{
+			try {
+				types.parseBlock(separated[i]);
+			}
+			catch(const std::exception& e) {
+				std::cerr << C_RED << e.what() << C_RESET "\n";
+				std::cerr << C_YELLOW "Using default types...\n" C_RESET;
+				types = MimeTypes();
+			}
+			continue ;
+		}
+		Config tmp;
+		try {
+			tmp.parseBlock(separated[i]);
+			servers.push_back(tmp);
+		}
+		catch(const std::exception& e) {
+			std::cerr << "Failure on Server index " C_RED << i << C_RESET "\n";
+			std::cerr << C_RED << e.what() << C_RESET "\n";
+			std::cerr << C_YELLOW "Continuing with parsing other servers...\n" C_RESET;
+		}
+	}
+	return (servers);
+}
+
+void	runWorker(std::vector<Config> const& servers, Events const& events, MimeTypes const& types, size_t id, std::atomic<size_t>& failures)
+{
+	try
+	{
+		WebServer	webserv(servers, events, types);
+		webserv.run();
+	}
+	catch(const WebservException& e) {
+		std::cerr << "worker " << id << ": " << e.what() << '\n';
+		failures++;
+	}
+}
+
+int	runWorkers(std::vector<Config> const& servers, Events const& events, MimeTypes const& types)
+{
+	std::vector<std::thread>	workers;
+	std::atomic<size_t>			failures(0);
+	unsigned int				nCores = std::max(std::thread::hardware_concurrency(), 1u);
+	cpu_set_t					cpuSet;
+
+	std::cout << "Starting " C_GREEN << events.getWorkers() << C_RESET " workers\n";
+	for (size_t i = 0; i < events.getWorkers(); i++)
+	{
+		workers.emplace_back(runWorker, std::cref(servers), std::cref(events), std::cref(types), i, std::ref(failures));
+		if (events.getCpuAffinity() == true)
+		{
+			CPU_ZERO(&cpuSet);
+			CPU_SET(i % nCores, &cpuSet);
+			if (pthread_setaffinity_np(workers.back().native_handle(), sizeof(cpuSet), &cpuSet) != 0)
+				std::cerr << C_YELLOW "failed to pin worker " << i << " to core " << i % nCores << "\n" C_RESET;
+		}
+	}
+	for (auto& worker : workers)
+		worker.join();
+	return (failures == workers.size() ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+int main(int ac, char **av)
+{
+	std::vector<Config> servers;
+	Events				events;
+	MimeTypes			types;
+
+	signal(SIGPIPE, SIG_IGN);		// peers closing sockets or pipes are handled through send/write errors
+	if (ac > 2)
+	{
+		std::cerr << C_RED "Wrong amount of arguments - valid usage: ./" << av[0] << " [config_file_path]\n";
+		return (EXIT_FAILURE);
+	}
+	else if (ac == 2)	// custom configuration
+	{
+		std::cout << "Using config: " << C_GREEN << av[1] << C_RESET << "\n";
+		servers = parseServers(av[1], events, types);
+	}
+	else				// default configuration
+	{
+		std::cout << "No argument provided, using default config: " C_GREEN << DEF_CONF_PATH << C_RESET << "\n";
+		servers = parseServers(DEF_CONF_PATH, events, types);
+	}
+	types.compile();		// before the workers start, read only afterwards
+	if (events.getWorkers() > 1)
+		return (runWorkers(servers, events, types));
+	try
+	{
+		WebServer	webserv(servers, events, types);
+		webserv.run();
+	}
+	catch(const WebservException& e) {
+		std::cerr << e.what() << '\n';
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
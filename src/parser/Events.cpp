@@ -0,0 +1,244 @@
+#include "Events.hpp"
+
+Events::Events(void)
+{
+	engine = DEF_ENGINE;
+	workers = DEF_WORKERS;
+	cpu_affinity = DEF_CPU_AFFINITY;
+	file_cache_size = DEF_FILE_CACHE_SIZE;
+	gzip_cache_size = DEF_GZIP_CACHE_SIZE;
+	open_file_cache_max = DEF_OPEN_FILE_CACHE_MAX;
+	open_file_cache_inactive = DEF_OPEN_FILE_CACHE_INACTIVE;
+	open_file_cache_valid = DEF_OPEN_FILE_CACHE_VALID;
+}
+
+Events::Events(const Events& copy) :
+	engine(copy.engine),
+	workers(copy.workers),
+	cpu_affinity(copy.cpu_affinity),
+	file_cache_size(copy.file_cache_size),
+	gzip_cache_size(copy.gzip_cache_size),
+	open_file_cache_max(copy.open_file_cache_max),
+	open_file_cache_inactive(copy.open_file_cache_inactive),
+	open_file_cache_valid(copy.open_file_cache_valid)
+{
+
+}
+
+Events&	Events::operator=(const Events& assign)
+{
+	if (this != &assign)
+	{
+		engine = assign.engine;
+		workers = assign.workers;
+		cpu_affinity = assign.cpu_affinity;
+		file_cache_size = assign.file_cache_size;
+		gzip_cache_size = assign.gzip_cache_size;
+		open_file_cache_max = assign.open_file_cache_max;
+		open_file_cache_inactive = assign.open_file_cache_inactive;
+		open_file_cache_valid = assign.open_file_cache_valid;
+	}
+	return (*this);
+}
+
+Events::~Events(void)
+{
+
+}
+
+void	Events::_parseUse(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty())
+		throw ParserException({"'use' can't have an empty parameter"});
+	if (block.front() == "epoll")
+		engine = ENGINE_EPOLL;
+	else if (block.front() == "poll")
+		engine = ENGINE_POLL;
+	else if (block.front() == "io_uring")
+		engine = ENGINE_IO_URING;
+	else
+		throw ParserException({"'use' can only have 'epoll', 'poll' or 'io_uring' as parameter, got: '" + block.front() + "'"});
+	block.erase(block.begin());
+	if (block.empty() || block.front() != ";")
+		throw ParserException({"'use' expects a single parameter followed by a ';'"});
+	block.erase(block.begin());
+}
+
+void	Events::_parseWorkers(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty() || block.front() == ";")
+		throw ParserException({"'workers' can't have an empty parameter"});
+	if (block.front() == "auto")
+		workers = std::max(std::thread::hardware_concurrency(), 1u);
+	else
+	{
+		if (block.front().find_first_not_of("0123456789") != std::string::npos)
+			throw ParserException({"'workers' must be a positive number or 'auto': '" + block.front() + "'"});
+		try {
+			workers = std::stoul(block.front());
+		}
+		catch (const std::exception& e) {
+			throw ParserException({"'workers' value is out of range: '" + block.front() + "'"});
+		}
+		if (workers == 0 || workers > MAX_WORKERS)
+			throw ParserException({"'workers' must be between 1 and " + std::to_string(MAX_WORKERS) + ": '" + block.front() + "'"});
+	}
+	block.erase(block.begin());
+	if (block.empty() || block.front() != ";")
+		throw ParserException({"'workers' expects a single parameter followed by a ';'"});
+	block.erase(block.begin());
+}
+
+void	Events::_parseCpuAffinity(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty() || block.front() == ";")
+		throw ParserException({"'worker_cpu_affinity' can't have an empty parameter"});
+	if (block.front() == "on")
+		cpu_affinity = true;
+	else if (block.front() == "off")
+		cpu_affinity = false;
+	else
+		throw ParserException({"'worker_cpu_affinity' can only have 'on' or 'off' as parameter"});
+	block.erase(block.begin());
+	if (block.empty() || block.front() != ";")
+		throw ParserException({"'worker_cpu_affinity' expects a single parameter followed by a ';'"});
+	block.erase(block.begin());
+}
+
+void	Events::_parseFileCacheSize(strings_t& block)
+{
+	file_cache_size = Parameters::parseSizeValue(block);
+}
+
+void	Events::_parseGzipCacheSize(strings_t& block)
+{
+	gzip_cache_size = Parameters::parseSizeValue(block);
+}
+
+// positive number with an optional 's' for the time values
+static size_t	parseCount(std::string const& name, std::string value, bool isTime)
+{
+	if (isTime && !value.empty() && value.back() == 's')
+		value.pop_back();
+	if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+		throw ParserException({"'" + name + "' expects a positive number" + (isTime ? " of seconds" : "") + ": '" + value + "'"});
+	try {
+		return (std::stoul(value));
+	}
+	catch (const std::exception& e) {
+		throw ParserException({"'" + name + "' value is out of range: '" + value + "'"});
+	}
+}
+
+// open_file_cache off; | open_file_cache max=N [inactive=Ns];
+void	Events::_parseOpenFileCache(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty() || block.front() == ";")
+		throw ParserException({"'open_file_cache' can't have an empty parameter"});
+	if (block.front() == "off")
+	{
+		open_file_cache_max = 0;
+		block.erase(block.begin());
+	}
+	while (!block.empty() && block.front() != ";")
+	{
+		if (block.front().compare(0, 4, "max=") == 0)
+			open_file_cache_max = parseCount("open_file_cache max", block.front().substr(4), false);
+		else if (block.front().compare(0, 9, "inactive=") == 0)
+			open_file_cache_inactive = parseCount("open_file_cache inactive", block.front().substr(9), true);
+		else
+			throw ParserException({"'open_file_cache' can only have 'off', 'max=N' or 'inactive=Ns' as parameter, got: '" + block.front() + "'"});
+		block.erase(block.begin());
+	}
+	if (block.empty() || block.front() != ";")
+		throw ParserException({"'open_file_cache' parameters must be followed by a ';'"});
+	block.erase(block.begin());
+}
+
+void	Events::_parseOpenFileCacheValid(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty() || block.front() == ";")
+		throw ParserException({"'open_file_cache_valid' can't have an empty parameter"});
+	open_file_cache_valid = parseCount("open_file_cache_valid", block.front(), true);
+	block.erase(block.begin());
+	if (block.empty() || block.front() != ";")
+		throw ParserException({"'open_file_cache_valid' expects a single parameter followed by a ';'"});
+	block.erase(block.begin());
+}
+
+void	Events::parseBlock(strings_t& block)
+{
+	if (block.front() != "events")
+		throw ParserException({"first arg is not 'events'"});
+	block.erase(block.begin());
+	if (block.front() != "{")
+		throw ParserException({"after an 'events' directive a '{' is expected"});
+	block.erase(block.begin());
+	if (block.back() != "}")
+		throw ParserException({"last element is not a '}"});
+	block.pop_back();
+	while (block.empty() == false)
+	{
+		if (block.front() == "use")
+			_parseUse(block);
+		else if (block.front() == "workers")
+			_parseWorkers(block);
+		else if (block.front() == "worker_cpu_affinity")
+			_parseCpuAffinity(block);
+		else if (block.front() == "file_cache_size")
+			_parseFileCacheSize(block);
+		else if (block.front() == "gzip_cache_size")
+			_parseGzipCacheSize(block);
+		else if (block.front() == "open_file_cache")
+			_parseOpenFileCache(block);
+		else if (block.front() == "open_file_cache_valid")
+			_parseOpenFileCacheValid(block);
+		else
+			throw ParserException({"'" + block.front() + "' is not a valid parameter in 'events' context"});
+	}
+}
+
+PollerEngine	Events::getEngine(void) const
+{
+	return (engine);
+}
+
+size_t	Events::getWorkers(void) const
+{
+	return (workers);
+}
+
+bool	Events::getCpuAffinity(void) const
+{
+	return (cpu_affinity);
+}
+
+size_t	Events::getFileCacheSize(void) const
+{
+	return (file_cache_size);
+}
+
+size_t	Events::getGzipCacheSize(void) const
+{
+	return (gzip_cache_size);
+}
+
+size_t	Events::getOpenFileCacheMax(void) const
+{
+	return (open_file_cache_max);
+}
+
+std::time_t	Events::getOpenFileCacheInactive(void) const
+{
+	return (open_file_cache_inactive);
+}
+
+std::time_t	Events::getOpenFileCacheValid(void) const
+{
+	return (open_file_cache_valid);
+}
@@ -0,0 +1,191 @@
+#include "MimeTypes.hpp"
+
+MimeTypes::MimeTypes(void)
+{
+
+}
+
+MimeTypes::MimeTypes(const MimeTypes& copy) :
+	declared(copy.declared),
+	slots(copy.slots),
+	seeds(copy.seeds)
+{
+
+}
+
+MimeTypes&	MimeTypes::operator=(const MimeTypes& assign)
+{
+	if (this != &assign)
+	{
+		declared = assign.declared;
+		slots = assign.slots;
+		seeds = assign.seeds;
+	}
+	return (*this);
+}
+
+MimeTypes::~MimeTypes(void)
+{
+
+}
+
+// types { type ext ext; ... } blocks add up, the last declaration of an extension wins
+void	MimeTypes::parseBlock(strings_t& block)
+{
+	block.erase(block.begin());
+	if (block.empty() || block.front() != "{")
+		throw ParserException({"after a 'types' directive a '{' is expected"});
+	block.erase(block.begin());
+	if (block.empty() || block.back() != "}")
+		throw ParserException({"last element of 'types' is not a '}'"});
+	block.pop_back();
+	while (!block.empty())
+		_parseType(block);
+}
+
+void	MimeTypes::_parseType(strings_t& block)
+{
+	std::string const	type = block.front();
+	std::string			extension;
+
+	if (type.find('/') == std::string::npos || type.find_first_of("{};") != std::string::npos)
+		throw ParserException({"'types' expects media types like 'text/html': '" + type + "'"});
+	block.erase(block.begin());
+	if (block.empty() || block.front() == ";")
+		throw ParserException({"'" + type + "' has no extension"});
+	while (!block.empty() && block.front() != ";")
+	{
+		extension = block.front();
+		if (extension.size() > MIME_EXT_MAX || extension.find_first_of("/.{}") != std::string::npos)
+			throw ParserException({"invalid extension for '" + type + "': '" + extension + "'"});
+		for (char& c : extension)
+			c = std::tolower(static_cast<unsigned char>(c));
+		declared.emplace_back(extension, type);
+		block.erase(block.begin());
+	}
+	if (block.empty())
+		throw ParserException({"no ';' terminator after the extensions of '" + type + "'"});
+	block.erase(block.begin());
+}
+
+// without any 'types' block the few types the server always knew are used
+void	MimeTypes::compile(void)
+{
+	types_t	types;
+	size_t	size = MIME_TABLE_MIN;
+
+	if (declared.empty())
+		declared = DEF_MIME_TYPES;
+	for (auto const& entry : declared)
+		types[entry.first] = entry.second;
+	while (size < types.size() + types.size() / 4)
+		size <<= 1;
+	while (_place(types, size) == false)
+		size <<= 1;
+}
+
+// extensions are spread in buckets by a first hash, then each bucket, largest first, gets
+// the first seed sending all its extensions to free slots
+bool	MimeTypes::_place(types_t const& types, size_t size)
+{
+	std::vector<std::vector<types_t::value_type const*>>	buckets(size / MIME_BUCKET_LOAD);
+	std::vector<size_t>	order(buckets.size()), picked;
+	uint32_t			seed = 1;
+
+	slots.assign(size, t_Slot());
+	seeds.assign(buckets.size(), 0);
+	for (auto const& entry : types)
+		buckets[_hash(entry.first, 0) & (buckets.size() - 1)].push_back(&entry);
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+		return (buckets[a].size() > buckets[b].size());
+	});
+	for (size_t b : order)
+	{
+		if (buckets[b].empty())
+			break ;
+		for (seed = 1; _fitBucket(buckets[b], seed, picked) == false; seed++)
+		{
+			if (seed == MIME_SEED_TRIES)
+				return (false);
+		}
+		seeds[b] = seed;
+		for (size_t i = 0; i < picked.size(); i++)
+			slots[picked[i]] = {buckets[b][i]->first, render(buckets[b][i]->second)};
+	}
+	return (true);
+}
+
+bool	MimeTypes::_fitBucket(std::vector<types_t::value_type const*> const& bucket, uint32_t seed, std::vector<size_t>& picked) const
+{
+	size_t	slot = 0;
+
+	picked.clear();
+	for (auto const* entry : bucket)
+	{
+		slot = _hash(entry->first, seed) & (slots.size() - 1);
+		if (!slots[slot].extension.empty() || std::find(picked.begin(), picked.end(), slot) != picked.end())
+			return (false);
+		picked.push_back(slot);
+	}
+	return (true);
+}
+
+// extension without its dot, any case
+const t_MimeType*	MimeTypes::find(std::string_view extension) const noexcept
+{
+	char	lower[MIME_EXT_MAX];
+	size_t	slot = 0;
+
+	if (extension.empty() || extension.size() > MIME_EXT_MAX || slots.empty())
+		return (nullptr);
+	for (size_t i = 0; i < extension.size(); i++)
+		lower[i] = std::tolower(static_cast<unsigned char>(extension[i]));
+	extension = std::string_view(lower, extension.size());
+	slot = _hash(extension, seeds[_hash(extension, 0) & (seeds.size() - 1)]) & (slots.size() - 1);
+	if (slots[slot].extension != extension)
+		return (nullptr);
+	return (&slots[slot].mime);
+}
+
+t_MimeType	MimeTypes::render(std::string const& type)
+{
+	return (t_MimeType{type, std::string(HTTP_HEADER_CONT_TYPE) + ": " + type + "\r\n"});
+}
+
+// types a 'charset' applies to
+bool	MimeTypes::takesCharset(std::string_view type) noexcept
+{
+	static constexpr std::string_view	others[] = CHARSET_TYPES;
+
+	if (type.compare(0, 5, "text/") == 0)
+		return (true);
+	return (std::find(std::begin(others), std::end(others), type) != std::end(others));
+}
+
+// table of the responses built without a configuration
+const MimeTypes&	MimeTypes::builtin(void)
+{
+	static MimeTypes const	types = []() {
+		MimeTypes	defaults;
+
+		defaults.compile();
+		return (defaults);
+	}();
+
+	return (types);
+}
+
+// FNV-1a with the seed folded into the offset basis
+uint64_t	MimeTypes::_hash(std::string_view key, uint32_t seed) noexcept
+{
+	uint64_t	hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+
+	for (char c : key)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return (hash ^ (hash >> 32));
+}
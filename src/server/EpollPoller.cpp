@@ -0,0 +1,107 @@
+#ifdef __linux__
+#include "EpollPoller.hpp"
+
+EpollPoller::EpollPoller( void ) : _epollFd(-1), _events(POLLER_MAX_EVENTS)
+{
+	this->_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (this->_epollFd == -1)
+		throw(ServerException({"epoll_create1 failed:", strerror(errno)}));
+}
+
+EpollPoller::~EpollPoller( void )
+{
+	close(this->_epollFd);
+}
+
+void	EpollPoller::addFd( int fd, short events )
+{
+	struct epoll_event	event = {};
+
+	event.events = _toEpoll(events);
+	event.data.fd = fd;
+	if (epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+	{
+		if (errno != EPERM)
+			throw(ServerException({"epoll_ctl failed to add fd", std::to_string(fd), "-", strerror(errno)}));
+		this->_alwaysReady[fd] = events;
+	}
+}
+
+void	EpollPoller::modFd( int fd, short events )
+{
+	struct epoll_event	event = {};
+
+	if (this->_alwaysReady.count(fd) > 0)
+	{
+		this->_alwaysReady[fd] = events;
+		return ;
+	}
+	event.events = _toEpoll(events);
+	event.data.fd = fd;
+	if (epoll_ctl(this->_epollFd, EPOLL_CTL_MOD, fd, &event) == -1)
+		throw(ServerException({"epoll_ctl failed to modify fd", std::to_string(fd), "-", strerror(errno)}));
+}
+
+void	EpollPoller::delFd( int fd ) noexcept
+{
+	if (this->_alwaysReady.erase(fd) == 0)
+		epoll_ctl(this->_epollFd, EPOLL_CTL_DEL, fd, nullptr);	// must be explicit: forked CGIs keep the file description alive
+}
+
+void	EpollPoller::wait( std::vector<struct pollfd>& ready, int timeoutMs )
+{
+	int	nEvents = -1;
+
+	ready.clear();
+	for (auto const& item : this->_alwaysReady)
+	{
+		if (item.second & (POLLIN | POLLOUT))
+			timeoutMs = 0;				// don't sleep while there are files to read
+	}
+	nEvents = epoll_wait(this->_epollFd, this->_events.data(), this->_events.size(), timeoutMs);
+	if (nEvents < 0)
+	{
+		if (errno == EINTR)
+			return ;
+		throw(ServerException({"epoll_wait failed:", strerror(errno)}));
+	}
+	for (int i=0; i<nEvents; i++)
+		ready.push_back({this->_events[i].data.fd, 0, _fromEpoll(this->_events[i].events)});
+	for (auto const& item : this->_alwaysReady)
+	{
+		if (item.second & (POLLIN | POLLOUT))
+			ready.push_back({item.first, item.second, static_cast<short>(item.second & (POLLIN | POLLOUT))});
+	}
+}
+
+std::string	EpollPoller::getName( void ) const noexcept
+{
+	return ("epoll");
+}
+
+uint32_t	EpollPoller::_toEpoll( short events ) const noexcept
+{
+	uint32_t	epollEvents = 0;
+
+	if (events & POLLIN)
+		epollEvents |= EPOLLIN;
+	if (events & POLLOUT)
+		epollEvents |= EPOLLOUT;
+	return (epollEvents);
+}
+
+short	EpollPoller::_fromEpoll( uint32_t epollEvents ) const noexcept
+{
+	short	events = 0;
+
+	if (epollEvents & EPOLLIN)
+		events |= POLLIN;
+	if (epollEvents & EPOLLOUT)
+		events |= POLLOUT;
+	if (epollEvents & EPOLLHUP)
+		events |= POLLHUP;
+	if (epollEvents & EPOLLERR)
+		events |= POLLERR;
+	return (events);
+}
+#endif
@@ -0,0 +1,58 @@
+#include "PollPoller.hpp"
+
+void	PollPoller::addFd( int fd, short events )
+{
+	if (this->_indexes.count(fd) > 0)
+		throw(ServerException({"fd", std::to_string(fd), "already registered"}));
+	this->_indexes[fd] = this->_pollfds.size();
+	this->_pollfds.push_back({fd, events, 0});
+}
+
+void	PollPoller::modFd( int fd, short events )
+{
+	this->_pollfds.at(this->_indexes.at(fd)).events = events;
+}
+
+void	PollPoller::delFd( int fd ) noexcept
+{
+	auto	toDrop = this->_indexes.find(fd);
+
+	if (toDrop == this->_indexes.end())
+		return ;
+	if (toDrop->second != this->_pollfds.size() - 1)		// swap with last item
+	{
+		this->_pollfds[toDrop->second] = this->_pollfds.back();
+		this->_indexes[this->_pollfds[toDrop->second].fd] = toDrop->second;
+	}
+	this->_pollfds.pop_back();
+	this->_indexes.erase(toDrop);
+}
+
+void	PollPoller::wait( std::vector<struct pollfd>& ready, int timeoutMs )
+{
+	int	nEvents = -1;
+
+	ready.clear();
+	nEvents = poll(this->_pollfds.data(), this->_pollfds.size(), timeoutMs);
+	if (nEvents < 0)
+	{
+		if ((errno == EINTR) or (errno == EAGAIN))
+			return ;
+		throw(ServerException({"poll failed"}));
+	}
+	for (auto const& item : this->_pollfds)
+	{
+		if (nEvents == 0)
+			break ;
+		if (item.revents != 0)
+		{
+			ready.push_back(item);
+			nEvents--;
+		}
+	}
+}
+
+std::string	PollPoller::getName( void ) const noexcept
+{
+	return ("poll");
+}
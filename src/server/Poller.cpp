@@ -0,0 +1,34 @@
+#include "Poller.hpp"
+#include "EpollPoller.hpp"
+#include "PollPoller.hpp"
+#include "UringPoller.hpp"
+
+Poller*	Poller::create( PollerEngine engine )
+{
+	if (engine == ENGINE_IO_URING)
+	{
+#ifdef WEBSERV_HAS_IO_URING
+		try {
+			return (new UringPoller());
+		}
+		catch (const ServerException& e) {
+			std::cerr << e.what() << " - falling back to epoll\n";
+		}
+#else
+		std::cerr << "io_uring is not available on this system - falling back to epoll\n";
+#endif
+		engine = ENGINE_EPOLL;
+	}
+#ifdef __linux__
+	if (engine == ENGINE_EPOLL)
+	{
+		try {
+			return (new EpollPoller());
+		}
+		catch (const ServerException& e) {
+			std::cerr << e.what() << " - falling back to poll\n";
+		}
+	}
+#endif
+	return (new PollPoller());
+}
@@ -0,0 +1,165 @@
+#include "TimerWheel.hpp"
+
+TimerWheel::TimerWheel( void ) :
+	_start(steady_clock::now()),
+	_currentTick(0),
+	_pending(0)
+{
+	for (int level=0; level<TIMER_LEVELS; level++)
+	{
+		this->_occupied[level] = 0;
+		for (int slot=0; slot<TIMER_SLOTS; slot++)
+			this->_slots[level][slot].prev = this->_slots[level][slot].next = &this->_slots[level][slot];
+	}
+	this->_expired.prev = this->_expired.next = &this->_expired;
+}
+
+void	TimerWheel::arm( t_Timer& timer, milliseconds timeout )
+{
+	uint64_t	ticks = (timeout.count() + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+
+	cancel(timer);
+	advance();		// keeps _currentTick close to now, the loop may have slept
+	timer.expiry = this->_currentTick + std::max(ticks, static_cast<uint64_t>(1));
+	_place(timer);
+	if (timer.level < TIMER_LEVELS)
+		this->_pending++;
+}
+
+void	TimerWheel::cancel( t_Timer& timer ) noexcept
+{
+	if (timer.next == nullptr)
+		return ;
+	timer.prev->next = timer.next;
+	timer.next->prev = timer.prev;
+	timer.prev = timer.next = nullptr;
+	if (timer.level < TIMER_LEVELS)
+	{
+		this->_pending--;
+		if (this->_slots[timer.level][timer.slot].next == &this->_slots[timer.level][timer.slot])
+			this->_occupied[timer.level] &= ~(1ULL << timer.slot);
+	}
+}
+
+void	TimerWheel::advance( void ) noexcept
+{
+	uint64_t	nowTick = _nowTick();
+	int			slot = 0;
+
+	if (this->_pending == 0)
+	{
+		this->_currentTick = std::max(nowTick, this->_currentTick);
+		return ;
+	}
+	while (this->_currentTick < nowTick)
+	{
+		this->_currentTick++;
+		for (int level=1; level<TIMER_LEVELS; level++)		// a lower level wrapped around: bring down the next slot of the upper one
+		{
+			if ((this->_currentTick & ((1ULL << (TIMER_SLOT_BITS * level)) - 1)) != 0)
+				break ;
+			_cascade(level, (this->_currentTick >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1));
+		}
+		slot = this->_currentTick & (TIMER_SLOTS - 1);
+		_cascade(0, slot);
+		if (this->_pending == 0)
+		{
+			this->_currentTick = nowTick;
+			break ;
+		}
+	}
+}
+
+t_Timer*	TimerWheel::popExpired( void ) noexcept
+{
+	t_Timer	*timer = this->_expired.next;
+
+	if (timer == &this->_expired)
+		return (nullptr);
+	cancel(*timer);
+	return (timer);
+}
+
+int		TimerWheel::msUntilNext( void ) const noexcept
+{
+	uint64_t	ticksToNext = UINT64_MAX, bits = 0, levelIndex = 0, distance = 0, target = 0;
+	int			shift = 0;
+
+	if (this->_expired.next != &this->_expired)
+		return (0);
+	if (this->_pending == 0)
+		return (-1);
+	for (int level=0; level<TIMER_LEVELS; level++)
+	{
+		if (this->_occupied[level] == 0)
+			continue ;
+		shift = TIMER_SLOT_BITS * level;
+		levelIndex = (this->_currentTick >> shift) & (TIMER_SLOTS - 1);
+		bits = this->_occupied[level];
+		bits = (bits >> ((levelIndex + 1) % TIMER_SLOTS)) | (bits << ((TIMER_SLOTS - levelIndex - 1) % TIMER_SLOTS));	// rotate: bit 0 is the slot after the current one
+		distance = __builtin_ctzll(bits) + 1;
+		target = (((this->_currentTick >> shift) + distance) << shift);		// tick at which the slot expires (level 0) or cascades
+		ticksToNext = std::min(ticksToNext, target - this->_currentTick);
+	}
+	target = (this->_currentTick + ticksToNext) * TIMER_TICK_MS;
+	milliseconds untilNext = duration_cast<milliseconds>(this->_start + milliseconds(target) - steady_clock::now());
+	return (std::max(static_cast<int>(untilNext.count()) + 1, 0));
+}
+
+uint64_t	TimerWheel::_nowTick( void ) const noexcept
+{
+	return (duration_cast<milliseconds>(steady_clock::now() - this->_start).count() / TIMER_TICK_MS);
+}
+
+void	TimerWheel::_place( t_Timer& timer ) noexcept
+{
+	uint64_t	maxDelta = (1ULL << (TIMER_SLOT_BITS * TIMER_LEVELS)) - 1;
+	uint64_t	delta = 0;
+
+	if (timer.expiry <= this->_currentTick)
+	{
+		timer.level = TIMER_LEVELS;
+		_link(this->_expired, timer);
+		return ;
+	}
+	delta = timer.expiry - this->_currentTick;
+	if (delta > maxDelta)
+	{
+		timer.expiry = this->_currentTick + maxDelta;
+		delta = maxDelta;
+	}
+	for (int level=0; level<TIMER_LEVELS; level++)
+	{
+		if (delta < (1ULL << (TIMER_SLOT_BITS * (level + 1))))
+		{
+			timer.level = level;
+			timer.slot = (timer.expiry >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1);
+			_link(this->_slots[level][timer.slot], timer);
+			this->_occupied[level] |= (1ULL << timer.slot);
+			return ;
+		}
+	}
+}
+
+void	TimerWheel::_link( t_Timer& sentinel, t_Timer& timer ) noexcept
+{
+	timer.prev = sentinel.prev;
+	timer.next = &sentinel;
+	sentinel.prev->next = &timer;
+	sentinel.prev = &timer;
+}
+
+void	TimerWheel::_cascade( int level, int slot ) noexcept
+{
+	t_Timer	*sentinel = &this->_slots[level][slot];
+	t_Timer	*timer = nullptr;
+
+	while (sentinel->next != sentinel)		// level 0 timers are due, the others land in lower levels
+	{
+		timer = sentinel->next;
+		cancel(*timer);
+		_place(*timer);
+		if (timer->level < TIMER_LEVELS)
+			this->_pending++;
+	}
+}
@@ -0,0 +1,240 @@
+#include "UringPoller.hpp"
+#ifdef WEBSERV_HAS_IO_URING
+
+UringPoller::UringPoller( void ) :
+	_ringFd(-1),
+	_ring(MAP_FAILED),
+	_ringSize(0),
+	_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+	_sqesSize(0),
+	_sqLocalTail(0),
+	_nextGen(0)
+{
+	struct io_uring_params	params;
+	size_t					sqRingSize, cqRingSize;
+	char					*ring = nullptr;
+
+	std::memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_COOP_TASKRUN;
+	this->_ringFd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	if ((this->_ringFd == -1) and (errno == EINVAL))		// older kernel, retry without optional flags
+	{
+		std::memset(&params, 0, sizeof(params));
+		this->_ringFd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+	}
+	if (this->_ringFd == -1)
+		throw(ServerException({"io_uring_setup failed:", strerror(errno)}));
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP) or !(params.features & IORING_FEAT_EXT_ARG))
+	{
+		close(this->_ringFd);
+		throw(ServerException({"io_uring: kernel lacks required features"}));
+	}
+	sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	this->_ringSize = std::max(sqRingSize, cqRingSize);
+	this->_ring = mmap(nullptr, this->_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_ringFd, IORING_OFF_SQ_RING);
+	this->_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	this->_sqes = static_cast<struct io_uring_sqe*>(mmap(nullptr, this->_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_ringFd, IORING_OFF_SQES));
+	if ((this->_ring == MAP_FAILED) or (this->_sqes == MAP_FAILED))
+	{
+		_unmap();
+		close(this->_ringFd);
+		throw(ServerException({"io_uring: failed to map rings:", strerror(errno)}));
+	}
+	ring = static_cast<char*>(this->_ring);
+	this->_sqHead = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+	this->_sqTail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+	this->_sqMask = reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+	this->_sqArray = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+	this->_sqEntries = params.sq_entries;
+	this->_sqLocalTail = *this->_sqTail;
+	this->_cqHead = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+	this->_cqTail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+	this->_cqMask = reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+	this->_cqes = reinterpret_cast<struct io_uring_cqe*>(ring + params.cq_off.cqes);
+}
+
+UringPoller::~UringPoller( void )
+{
+	_unmap();
+	close(this->_ringFd);
+}
+
+void	UringPoller::addFd( int fd, short events )
+{
+	if (this->_items.count(fd) > 0)
+		throw(ServerException({"fd", std::to_string(fd), "already registered"}));
+	this->_items[fd] = {events, 0, false, false};
+	_queueArm(fd, this->_items[fd]);
+}
+
+void	UringPoller::modFd( int fd, short events )
+{
+	t_UringItem&	item = this->_items.at(fd);
+
+	if (item.events == events)
+		return ;
+	item.events = events;
+	if (item.armed == true)
+		_removePoll(fd, item);
+	_queueArm(fd, item);
+}
+
+void	UringPoller::delFd( int fd ) noexcept
+{
+	auto	toDrop = this->_items.find(fd);
+
+	if (toDrop == this->_items.end())
+		return ;
+	if (toDrop->second.armed == true)
+		_removePoll(fd, toDrop->second);		// the armed poll holds a reference to the file
+	this->_items.erase(toDrop);
+}
+
+void	UringPoller::wait( std::vector<struct pollfd>& ready, int timeoutMs )
+{
+	struct __kernel_timespec		timeout = {};
+	struct io_uring_getevents_arg	arg = {};
+	unsigned						toSubmit = 0, minComplete = 0, cqHead = 0, cqTail = 0;
+
+	ready.clear();
+	for (int fd : this->_toArm)
+	{
+		auto item = this->_items.find(fd);
+		if ((item == this->_items.end()) or (item->second.queued == false))
+			continue ;
+		item->second.queued = false;
+		if (item->second.armed == false)
+			_armPoll(fd, item->second);
+	}
+	this->_toArm.clear();
+	__atomic_store_n(this->_sqTail, this->_sqLocalTail, __ATOMIC_RELEASE);
+	toSubmit = this->_sqLocalTail - __atomic_load_n(this->_sqHead, __ATOMIC_ACQUIRE);
+	if (timeoutMs >= 0)
+	{
+		timeout.tv_sec = timeoutMs / 1000;
+		timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+		arg.ts = reinterpret_cast<uint64_t>(&timeout);
+	}
+	if ((timeoutMs != 0) and (__atomic_load_n(this->_cqTail, __ATOMIC_ACQUIRE) == *this->_cqHead))
+		minComplete = 1;
+	if (_enter(toSubmit, minComplete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) < 0)
+	{
+		if ((errno != ETIME) and (errno != EINTR) and (errno != EBUSY) and (errno != EAGAIN))
+			throw(ServerException({"io_uring_enter failed:", strerror(errno)}));
+	}
+	cqHead = *this->_cqHead;
+	cqTail = __atomic_load_n(this->_cqTail, __ATOMIC_ACQUIRE);
+	while (cqHead != cqTail)
+	{
+		_handleCqe(this->_cqes[cqHead & *this->_cqMask], ready);
+		cqHead++;
+	}
+	__atomic_store_n(this->_cqHead, cqHead, __ATOMIC_RELEASE);
+}
+
+std::string	UringPoller::getName( void ) const noexcept
+{
+	return ("io_uring");
+}
+
+struct io_uring_sqe*	UringPoller::_getSqe( void )
+{
+	struct io_uring_sqe	*sqe = nullptr;
+	unsigned			sqHead = __atomic_load_n(this->_sqHead, __ATOMIC_ACQUIRE);
+	unsigned			index = 0;
+
+	if (this->_sqLocalTail - sqHead >= this->_sqEntries)		// queue full, submit what we have without waiting
+	{
+		__atomic_store_n(this->_sqTail, this->_sqLocalTail, __ATOMIC_RELEASE);
+		if (_enter(this->_sqLocalTail - sqHead, 0, 0, nullptr, 0) < 0)
+			throw(ServerException({"io_uring_enter failed:", strerror(errno)}));
+		sqHead = __atomic_load_n(this->_sqHead, __ATOMIC_ACQUIRE);
+		if (this->_sqLocalTail - sqHead >= this->_sqEntries)
+			throw(ServerException({"io_uring: submission queue is full"}));
+	}
+	index = this->_sqLocalTail & *this->_sqMask;
+	sqe = &this->_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	this->_sqArray[index] = index;
+	this->_sqLocalTail++;
+	return (sqe);
+}
+
+void	UringPoller::_armPoll( int fd, t_UringItem& item )
+{
+	struct io_uring_sqe	*sqe = _getSqe();
+
+	item.gen = this->_nextGen++;
+	item.armed = true;
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = static_cast<uint16_t>(item.events);
+	sqe->user_data = (static_cast<uint64_t>(item.gen) << 32) | static_cast<uint32_t>(fd);
+}
+
+void	UringPoller::_removePoll( int fd, t_UringItem const& item ) noexcept
+{
+	struct io_uring_sqe	*sqe = nullptr;
+
+	try {
+		sqe = _getSqe();
+	}
+	catch (const ServerException& e) {
+		std::cerr << e.what() << '\n';
+		return ;
+	}
+	sqe->opcode = IORING_OP_POLL_REMOVE;
+	sqe->fd = -1;
+	sqe->addr = (static_cast<uint64_t>(item.gen) << 32) | static_cast<uint32_t>(fd);
+	sqe->user_data = URING_REMOVE_TAG;
+}
+
+void	UringPoller::_queueArm( int fd, t_UringItem& item ) noexcept
+{
+	item.armed = false;
+	if (item.queued == false)
+	{
+		item.queued = true;
+		this->_toArm.push_back(fd);
+	}
+}
+
+void	UringPoller::_handleCqe( struct io_uring_cqe const& cqe, std::vector<struct pollfd>& ready )
+{
+	int		fd = static_cast<int>(cqe.user_data & UINT32_MAX);
+	short	revents = 0;
+
+	if (cqe.user_data == URING_REMOVE_TAG)
+		return ;
+	auto item = this->_items.find(fd);
+	if ((item == this->_items.end()) or (item->second.armed == false) or (item->second.gen != (cqe.user_data >> 32)))
+		return ;		// stale completion of a removed or re-armed poll
+	if (!(cqe.flags & IORING_CQE_F_MORE))
+		_queueArm(fd, item->second);
+	if (cqe.res == -ECANCELED)
+		return ;
+	else if (cqe.res == -EBADF)
+		revents = POLLNVAL;
+	else if (cqe.res < 0)
+		revents = POLLERR;
+	else
+		revents = static_cast<short>(cqe.res) & (POLLIN | POLLOUT | POLLHUP | POLLERR | POLLNVAL);
+	ready.push_back({fd, item->second.events, revents});
+}
+
+int		UringPoller::_enter( unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize ) noexcept
+{
+	return (syscall(__NR_io_uring_enter, this->_ringFd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+void	UringPoller::_unmap( void ) noexcept
+{
+	if (this->_ring != MAP_FAILED)
+		munmap(this->_ring, this->_ringSize);
+	if (this->_sqes != MAP_FAILED)
+		munmap(this->_sqes, this->_sqesSize);
+	this->_ring = MAP_FAILED;
+	this->_sqes = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+}
+#endif
@@ -1,12 +1,20 @@
 #include "WebServer.hpp"
 
-WebServer::WebServer( t_serv_list const& servers )
+WebServer::WebServer( t_serv_list const& servers, Events const& events, MimeTypes const& types ) :
+	_servers(servers),
+	_mimeTypes(types),
+	_reusePort(events.getWorkers() > 1),
+	_poller(nullptr),
+	_nPollItems(0),
+	_fileCache(events.getFileCacheSize()),
+	_openFiles(events.getOpenFileCacheMax(), events.getOpenFileCacheInactive(), events.getOpenFileCacheValid()),
+	_gzipCache(events.getGzipCacheSize())
 {
 	std::vector<Listen>	distinctListeners;
 
 	if (servers.empty() == true)
 		throw(ServerException({"no Servers provided for configuration"}));
-	this->_servers = servers;
+	this->_poller = Poller::create(events.getEngine());
 	for (auto const& server : this->_servers)
 	{
 		for (auto const& address : server.getListens())
@@ -18,72 +26,81 @@ WebServer::WebServer( t_serv_list const& servers )
 	}
 	for (auto const& listener : distinctListeners)
 	{
+		for (auto const& server : this->_servers)		// servers are resolved once per listener and shared by all its requests
+		{
+			for (auto const& address : server.getListens())
+			{
+				if (address == listener)
+				{
+					this->_listenerServers[listener.getIpString() + ":" + listener.getPortString()].push_back(server);
+					break ;
+				}
+			}
+		}
 		try {
-			this->_listenTo(listener.getIpString(), listener.getPortString());
+			this->_listenTo(listener);
 		}
 		catch (const ServerException& e) {
 			std::cout << C_RED << e.what() << '\n' << C_RESET;
 		}
 	}
-	if (this->_pollfds.empty() == true)
+	if (this->_nPollItems == 0)
+	{
+		delete this->_poller;
 		throw(ServerException({"no available host:port in the configuration provided"}));
+	}
+	std::cout << C_GREEN << "event loop backend: " << this->_poller->getName() << "\n" << C_RESET;
+	std::cout << C_GREEN << "byte scanning: " << ByteScan::getEngineName() << "\n" << C_RESET;
 }
 
 WebServer::~WebServer ( void ) noexcept
 {
-	for (auto &item : this->_requests)
-		delete item.second;
-	for (auto &item : this->_responses)
-		delete item.second;
-	for (auto &item : this->_cgi)
-		delete item.second;
-	for (auto &item : this->_pollitems)
+	t_PollItem	*item = nullptr;
+
+	for (size_t fd = 0; fd < this->_slab.size() * SLAB_CHUNK_SIZE; fd++)
 	{
-		if ((item.second->pollType == LISTENER) or
-			(item.second->pollType == CLIENT_CONNECTION))
-			shutdown(item.first, SHUT_RDWR);
-		close(item.first);
-		delete item.second;
-	}
+		item = &this->_slab[fd >> SLAB_CHUNK_BITS][fd & (SLAB_CHUNK_SIZE - 1)];
+		if (item->active == false)
+			continue ;
+		if ((item->pollType == LISTENER) or
+			(item->pollType == CLIENT_CONNECTION))
+			shutdown(fd, SHUT_RDWR);
+		close(fd);
+		_clearStructs(fd);
+	}
+	for (t_PollItem *chunk : this->_slab)
+		delete[] chunk;
+	delete this->_poller;
 }
 
 void	WebServer::run( void )
 {
-	int				nConn = -1;
-	struct pollfd 	pollfdItem;
+	t_Timer	*expired = nullptr;
 
 	while (true)
 	{
-		nConn = poll(this->_pollfds.data(), this->_pollfds.size(), 0);
-		if (nConn < 0)
+		this->_poller->wait(this->_readyFds, this->_timers.msUntilNext());	// sleeps until an fd is ready or the next timer is due
+		ResponseHead::refreshDate(std::time(nullptr));						// one Date line per second for all responses
+		for (struct pollfd pollfdItem : this->_readyFds)
 		{
-			if ((errno != EAGAIN) and (errno != EWOULDBLOCK))
-				throw(ServerException({"poll failed"}));
-			continue;
-		}
-		else if (nConn == 0)
-			continue;
-		for(size_t i=0; i<this->_pollfds.size(); i++)
-		{
-			pollfdItem = this->_pollfds[i];
 			try {
-				if ((pollfdItem.revents & POLLIN) and (this->_pollitems[pollfdItem.fd]->pollType != CGI_RESPONSE_PIPE_READ_END))
+				if (_getPollItem(pollfdItem.fd)->dropping == true)		// dropped by an earlier event of this batch
+					continue ;
+				if (pollfdItem.revents & POLLIN)
 					_readData(pollfdItem.fd);
 				if ((pollfdItem.revents & POLLOUT) and !(pollfdItem.revents & POLLERR))	// POLLERR is expected when upload pipe is closed by CGI script
 					_writeData(pollfdItem.fd);
 				if (pollfdItem.revents & (POLLHUP | POLLERR | POLLNVAL)) 	// client-end side was closed / error / socket not valid
 				{
-					if ((pollfdItem.revents & POLLHUP) and (this->_pollitems[pollfdItem.fd]->pollType == CGI_RESPONSE_PIPE_READ_END))
+					if ((pollfdItem.revents & POLLHUP) and ((_getPollItem(pollfdItem.fd)->pollType == CGI_RESPONSE_PIPE_READ_END)
+						or (_getPollItem(pollfdItem.fd)->pollType == STATIC_FILE)))
 					{
-						if (this->_pollitems[pollfdItem.fd]->pollState == WAIT_FOR_CGI)
-							this->_pollitems[pollfdItem.fd]->pollState = READ_CGI_RESPONSE;
-						_readData(pollfdItem.fd);
+						if (_getPollItem(pollfdItem.fd)->dropping == false)		// writer gone, what it wrote is still to be read
+							_readData(pollfdItem.fd);
 					}
 					else
 						_dropConn(pollfdItem.fd);
 				}
-				if (!(pollfdItem.revents & POLLIN) and (this->_pollitems[pollfdItem.fd]->pollType == CLIENT_CONNECTION))
-					_checkTimeout(pollfdItem.fd);
 			}
 			catch (const HTTPexception& e) {
 				std::cout << C_RED << e.what()  << C_RESET << '\n';
@@ -97,14 +114,19 @@ void	WebServer::run( void )
 				_dropConn(pollfdItem.fd);
 			}
 		}
+		this->_timers.advance();
+		while ((expired = this->_timers.popExpired()) != nullptr)
+			_handleTimeout(*expired);
 		_clearEmptyConns();
 	}
 }
 
-void	WebServer::_listenTo( std::string const& hostname, std::string const& port )
+void	WebServer::_listenTo( Listen const& listener )
 {
-	struct addrinfo *tmp, *list, filter;
-	int 			yes=1, listenSocket=-1;
+	std::string const&	hostname = listener.getIpString();
+	std::string const&	port = listener.getPortString();
+	struct addrinfo 	*tmp, *list, filter;
+	int 				yes=1, listenSocket=-1;
 
 	filter.ai_flags = AI_PASSIVE;
 	filter.ai_family = AF_UNSPEC;
@@ -123,8 +145,12 @@ void	WebServer::_listenTo( std::string const& hostname, std::string const& port
 		if (listenSocket == -1)
 			continue;
 		fcntl(listenSocket, F_SETFL, O_NONBLOCK);
+		fcntl(listenSocket, F_SETFD, FD_CLOEXEC);
 		if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0)
 			std::cout << C_RED << "failed to update socket, trying to bind anyway... \n" << C_RESET;
+		if ((this->_reusePort == true) and (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) != 0))		// every worker owns a listener on the same address
+			std::cout << C_RED << "failed to set SO_REUSEPORT, trying to bind anyway... \n" << C_RESET;
+		_setListenOptions(listenSocket, listener);
 		if (bind(listenSocket, tmp->ai_addr, tmp->ai_addrlen) == 0)
 			break;
 		close(listenSocket);
@@ -136,7 +162,7 @@ void	WebServer::_listenTo( std::string const& hostname, std::string const& port
 		return ;
 	}
 	freeaddrinfo(list);
-	if (listen(listenSocket, BACKLOG) != 0)
+	if (listen(listenSocket, listener.getBacklog()) != 0)
 	{
 		close(listenSocket);
 		std::cout << C_RED << "failed listen on: " << hostname << ":" << port << "\n" << C_RESET;
@@ -148,9 +174,29 @@ void	WebServer::_listenTo( std::string const& hostname, std::string const& port
 	}
 }
 
+void	WebServer::_setListenOptions( int listenSocket, Listen const& listener ) const
+{
+	int	value = 0;
+
+	if ((value = listener.getRcvBuf()) != 0 and setsockopt(listenSocket, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value)) != 0)
+		std::cout << C_RED << "failed to set SO_RCVBUF on " << listener.getIpString() << ":" << listener.getPortString() << "\n" << C_RESET;
+	if ((value = listener.getSndBuf()) != 0 and setsockopt(listenSocket, SOL_SOCKET, SO_SNDBUF, &value, sizeof(value)) != 0)
+		std::cout << C_RED << "failed to set SO_SNDBUF on " << listener.getIpString() << ":" << listener.getPortString() << "\n" << C_RESET;
+	if ((value = listener.getNoDelay()) != 0 and setsockopt(listenSocket, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) != 0)
+		std::cout << C_RED << "failed to set TCP_NODELAY on " << listener.getIpString() << ":" << listener.getPortString() << "\n" << C_RESET;
+#ifdef __linux__
+	if ((value = listener.getDeferAccept()) != 0 and setsockopt(listenSocket, IPPROTO_TCP, TCP_DEFER_ACCEPT, &value, sizeof(value)) != 0)
+		std::cout << C_RED << "failed to set TCP_DEFER_ACCEPT on " << listener.getIpString() << ":" << listener.getPortString() << "\n" << C_RESET;
+#endif
+#ifdef TCP_FASTOPEN
+	if ((value = listener.getFastOpen()) != 0 and setsockopt(listenSocket, IPPROTO_TCP, TCP_FASTOPEN, &value, sizeof(value)) != 0)
+		std::cout << C_RED << "failed to set TCP_FASTOPEN on " << listener.getIpString() << ":" << listener.getPortString() << "\n" << C_RESET;
+#endif
+}
+
 void	WebServer::_readData( int readFd )
 {
-	switch (this->_pollitems[readFd]->pollState)
+	switch (_getPollItem(readFd)->pollState)
 	{
 		case WAITING_FOR_CONNECTION:
 			_handleNewConnection(readFd);
@@ -158,7 +204,6 @@ void	WebServer::_readData( int readFd )
 
 		case READ_REQ_HEADER:
 			_readRequestHead(readFd);
-			_resetTimeout(readFd);			// timeout between different requests, goes in idle mode after CONN_MAX_TIMEOUT seconds
 			break;
 
 		case READ_STATIC_FILE:
@@ -180,7 +225,7 @@ void	WebServer::_readData( int readFd )
 
 void	WebServer::_writeData( int writeFd )
 {
-	switch (this->_pollitems[writeFd]->pollState)
+	switch (_getPollItem(writeFd)->pollState)
 	{
 		case WRITE_TO_CGI:
 			_writeToCGI(writeFd);
@@ -201,116 +246,181 @@ void	WebServer::_addConn( int newSocket , fdType typePollItem, fdState statePoll
 
 	if (newSocket == -1)
 		throw(ServerException({"invalid file descriptor"}));
-	this->_pollfds.push_back({newSocket, POLLIN | POLLOUT, 0});
-	newPollitem = new PollItem;
+	while (static_cast<size_t>(newSocket) >= this->_slab.size() * SLAB_CHUNK_SIZE)
+		this->_slab.push_back(new t_PollItem[SLAB_CHUNK_SIZE]());		// chunks never move: timers point into them
+	this->_poller->addFd(newSocket, _getInterest(typePollItem, statePollItem));
+	newPollitem = &this->_slab[newSocket >> SLAB_CHUNK_BITS][newSocket & (SLAB_CHUNK_SIZE - 1)];
+	newPollitem->active = true;
+	newPollitem->dropping = false;
 	newPollitem->pollType = typePollItem;
 	newPollitem->pollState = statePollItem;
 	newPollitem->servIP = servIP;
 	newPollitem->servPort = servPort;
 	newPollitem->cliIP = cliIP;
 	newPollitem->cliPort = cliPort;
-	this->_pollitems[newSocket] = newPollitem;
-	_resetTimeout(newSocket);
+	newPollitem->owner = newSocket;
+	newPollitem->timer.fd = newSocket;
+	newPollitem->timer.prev = newPollitem->timer.next = nullptr;
+	newPollitem->request = nullptr;
+	newPollitem->response = nullptr;
+	newPollitem->cgi = nullptr;
+	newPollitem->pending.clear();
+	this->_nPollItems++;
 }
 
-void	WebServer::_dropConn(int toDrop) noexcept
+void	WebServer::_addAuxConn( int auxFd, fdType typePollItem, fdState statePollItem, int clientSocket )
 {
-	this->_emptyConns.push_back(toDrop);
+	_addConn(auxFd, typePollItem, statePollItem);
+	_getPollItem(auxFd)->owner = clientSocket;
 }
 
-void	WebServer::_clearEmptyConns( void ) noexcept
+t_PollItem*	WebServer::_getPollItem( int fd ) const
 {
-	int fdToDrop = -1;
-	while (this->_emptyConns.empty() == false)
+	t_PollItem	*item = nullptr;
+
+	if ((fd < 0) or (static_cast<size_t>(fd) >= this->_slab.size() * SLAB_CHUNK_SIZE))
+		throw(std::out_of_range("file descriptor out of the connection table"));
+	item = &this->_slab[fd >> SLAB_CHUNK_BITS][fd & (SLAB_CHUNK_SIZE - 1)];
+	if (item->active == false)
+		throw(std::out_of_range("file descriptor not in the connection table"));
+	return (item);
+}
+
+void	WebServer::_setState( int fd, fdState newState )
+{
+	t_PollItem	*pollItem = _getPollItem(fd);
+	fdState		oldState = pollItem->pollState;
+	short		oldInterest = _getInterest(pollItem->pollType, pollItem->pollState);
+	short		newInterest = _getInterest(pollItem->pollType, newState);
+
+	if (pollItem->pollState == newState)
+		return ;
+	pollItem->pollState = newState;
+	if (newState == WAIT_FOR_RESP_SPACE)		// a hung up pipe would be reported on every wait, even without interest
+		this->_poller->delFd(fd);
+	else if (oldState == WAIT_FOR_RESP_SPACE)
+		this->_poller->addFd(fd, newInterest);
+	else if (oldInterest != newInterest)
+		this->_poller->modFd(fd, newInterest);
+	if (pollItem->pollType == CLIENT_CONNECTION)
+		_armStateTimer(fd);
+}
+
+short	WebServer::_getInterest( fdType type, fdState state ) const noexcept
+{
+	switch (state)
 	{
-		fdToDrop = this->_emptyConns.back();
-		if ((this->_pollitems[fdToDrop]->pollType == LISTENER) or
-			(this->_pollitems[fdToDrop]->pollType == CLIENT_CONNECTION))		// it's a socket
-			shutdown(fdToDrop, SHUT_RDWR);
-		close(fdToDrop);
-		for (auto curr=this->_pollfds.begin(); curr != this->_pollfds.end(); curr++)
-		{
-			if (curr->fd == fdToDrop)
-			{
-				this->_pollfds.erase(curr);
-				break;
-			}
-		}
-		if (this->_pollitems[fdToDrop]->pollType == CLIENT_CONNECTION)
-			std::cout << C_GREEN << "closed connection with client: " << this->_pollitems[fdToDrop]->cliIP << ":" << this->_pollitems[fdToDrop]->cliPort << C_RESET << std::endl;
-		delete this->_pollitems[fdToDrop];
-		this->_pollitems.erase(fdToDrop);
-		_clearStructs(fdToDrop);
-		this->_emptyConns.pop_back();
+		case WAITING_FOR_CONNECTION:
+		case READ_REQ_HEADER:
+		case READ_STATIC_FILE:
+		case READ_REQ_BODY:
+		case READ_CGI_RESPONSE:		// output is sent while the CGI still runs
+			return (POLLIN);
+
+		case WRITE_TO_CLIENT:
+		case WRITE_TO_CGI:
+			return (POLLOUT);
+
+		case WAIT_FOR_CGI_INPUT:
+		case WAIT_FOR_CGI:
+		case WAIT_FOR_RESP_BODY:
+		case WAIT_FOR_REQ_BODY:
+		case WAIT_FOR_RESP_SPACE:
+		default:
+			(void) type;
+			return (0);
 	}
 }
 
-void	WebServer::_clearStructs( int toDrop) noexcept
+void	WebServer::_dropConn(int toDrop) noexcept
 {
-	if (this->_requests.count(toDrop) > 0)
-	{
-		delete this->_requests[toDrop];
-		this->_requests.erase(toDrop);
+	t_PollItem	*item = nullptr;
+
+	try {
+		item = _getPollItem(toDrop);
 	}
-	if (this->_responses.count(toDrop) > 0)
-	{
-		delete this->_responses[toDrop];
-		this->_responses.erase(toDrop);
+	catch (const std::out_of_range& e) {
+		return ;
 	}
-	if (this->_cgi.count(toDrop) > 0)
+	if (item->dropping == false)
 	{
-		delete this->_cgi[toDrop];
-		this->_cgi.erase(toDrop);
+		item->dropping = true;
+		this->_emptyConns.push_back(toDrop);
 	}
 }
 
-int		WebServer::_getSocketFromFd( int fd )
+void	WebServer::_clearEmptyConns( void ) noexcept
 {
-	if (this->_pollitems[fd]->pollType == CGI_REQUEST_PIPE_WRITE_END)
+	int 		fdToDrop = -1;
+	t_PollItem	*item = nullptr;
+
+	while (this->_emptyConns.empty() == false)
 	{
-		for (auto& item : this->_cgi)
-		{
-			if (item.second->getUploadPipe()[1] == fd)
-				return (item.second->getRequestSocket());
-		}
+		fdToDrop = this->_emptyConns.back();
+		this->_emptyConns.pop_back();
+		item = _getPollItem(fdToDrop);
+		if (item->pollType == CLIENT_CONNECTION)
+			_dropAuxConns(fdToDrop);		// their owner slot is about to be freed
+		if ((item->pollType == LISTENER) or
+			(item->pollType == CLIENT_CONNECTION))		// it's a socket
+			shutdown(fdToDrop, SHUT_RDWR);
+		this->_poller->delFd(fdToDrop);
+		this->_timers.cancel(item->timer);
+		close(fdToDrop);
+		if (item->pollType == CLIENT_CONNECTION)
+			std::cout << C_GREEN << "closed connection with client: " << item->cliIP << ":" << item->cliPort << C_RESET << std::endl;
+		_clearStructs(fdToDrop);
+		item->active = false;
+		this->_nPollItems--;
 	}
-	else if (this->_pollitems[fd]->pollType == CGI_RESPONSE_PIPE_READ_END)
+}
+
+void	WebServer::_dropAuxConns( int clientSocket ) noexcept
+{
+	t_PollItem	*client = _getPollItem(clientSocket);
+	t_PollItem	*aux = nullptr;
+	int			auxFds[3] = {-1, -1, -1};
+
+	if (client->cgi != nullptr)
 	{
-		for (auto& item : this->_cgi)
-		{
-			if (item.second->getResponsePipe()[0] == fd)
-				return (item.second->getRequestSocket());
-		}
+		auxFds[0] = client->cgi->getUploadPipe()[1];
+		auxFds[1] = client->cgi->getResponsePipe()[0];
 	}
-	else if (this->_pollitems[fd]->pollType == STATIC_FILE)
+	if (client->response != nullptr)
+		auxFds[2] = client->response->getHTMLfd();
+	for (int auxFd : auxFds)
 	{
-		for (auto& item : this->_responses)
-		{
-			if (item.second->getHTMLfd() == fd)
-				return (item.first);
+		try {
+			aux = _getPollItem(auxFd);
 		}
+		catch (const std::out_of_range& e) {
+			continue ;
+		}
+		if ((aux->pollType > CLIENT_CONNECTION) and (aux->owner == clientSocket))
+			_dropConn(auxFd);
 	}
-	else if (fd != -1)
-		return (fd);
-	throw(std::out_of_range("invalid file descriptor or not found:"));	// entity not found, this should not happen
 }
 
-t_serv_list	WebServer::_getServersFromIP( std::string const& ip, std::string const& port) const noexcept
+void	WebServer::_clearStructs( int toDrop) noexcept
 {
-	t_serv_list	matchingServers;
+	t_PollItem	*item = &this->_slab[toDrop >> SLAB_CHUNK_BITS][toDrop & (SLAB_CHUNK_SIZE - 1)];
+
+	delete item->request;
+	delete item->response;
+	delete item->cgi;
+	item->request = nullptr;
+	item->response = nullptr;
+	item->cgi = nullptr;
+}
 
-	for (auto const& server : this->_servers)
-	{
-		for (auto const& address : server.getListens())
-		{
-			if ((address.getIpString() == ip) and (address.getPortString() == port))
-			{
-				matchingServers.push_back(server);
-				break ;
-			}
-		}
-	}
-	return (matchingServers);
+int		WebServer::_getSocketFromFd( int fd )
+{
+	return (_getPollItem(fd)->owner);
+}
+
+t_serv_list const&	WebServer::_getServersFromIP( std::string const& ip, std::string const& port) const
+{
+	return (this->_listenerServers.at(ip + ":" + port));
 }
 
 path_t	WebServer::_getDefErrorPage( int statusCode ) const
@@ -329,214 +439,389 @@ path_t	WebServer::_getDefErrorPage( int statusCode ) const
 	throw(ServerException({"no default error page found for code", std::to_string(statusCode)}));
 }
 
-void	WebServer::_resetTimeout( int fd )
+void	WebServer::_armTimer( int fd, TimerType type )
+{
+	t_Timer&	timer = _getPollItem(fd)->timer;
+
+	timer.type = type;
+	switch (type)
+	{
+		case TIMER_HEADER:
+			this->_timers.arm(timer, seconds(HEADER_TIMEOUT));
+			break;
+		case TIMER_BODY:
+			this->_timers.arm(timer, seconds(BODY_TIMEOUT));
+			break;
+		case TIMER_KEEPALIVE:
+			this->_timers.arm(timer, seconds(CONN_MAX_TIMEOUT));
+			break;
+		case TIMER_SEND:
+			this->_timers.arm(timer, seconds(SEND_TIMEOUT));
+			break;
+		case TIMER_CGI:
+			this->_timers.arm(timer, seconds(CGI_TIMEOUT));
+			break;
+	}
+}
+
+void	WebServer::_armStateTimer( int clientSocket )
 {
-	this->_pollitems[fd]->lastActivity = steady_clock::now();
+	switch (_getPollItem(clientSocket)->pollState)
+	{
+		case READ_REQ_HEADER:		// response sent, waiting for the next request
+			_armTimer(clientSocket, TIMER_KEEPALIVE);
+			break;
+		case READ_REQ_BODY:
+			_armTimer(clientSocket, TIMER_BODY);
+			break;
+		case WRITE_TO_CLIENT:
+		case WAIT_FOR_RESP_BODY:	// a stalled source must not hold the connection either
+			_armTimer(clientSocket, TIMER_SEND);
+			break;
+		default:					// waiting for a file or a CGI, their fds have their own timers
+			this->_timers.cancel(_getPollItem(clientSocket)->timer);
+			break;
+	}
 }
 
-void	WebServer::_checkTimeout( int fd )
+void	WebServer::_handleTimeout( t_Timer const& timer ) noexcept
 {
-	duration<double> 	time_span;
+	t_PollItem	*pollItem = _getPollItem(timer.fd);
 
-	time_span = duration_cast<duration<int>>(steady_clock::now() - this->_pollitems[fd]->lastActivity);
-	if (time_span.count() > CONN_MAX_TIMEOUT)
-		throw(EndConnectionException());
+	try {
+		if (timer.type == TIMER_CGI)
+		{
+			std::cerr << C_RED << "CGI timeout, killing it" << C_RESET << '\n';
+			_getPollItem(_getSocketFromFd(timer.fd))->cgi->killCGIproc();
+			_redirectToErrorPage(timer.fd, 504);
+		}
+		else
+		{
+			std::cout << C_RED << "timeout on connection with client: " << pollItem->cliIP << ":" << pollItem->cliPort << C_RESET << '\n';
+			_dropConn(timer.fd);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << C_RED << e.what() << C_RESET << '\n';
+		_dropConn(timer.fd);
+	}
 }
 
 void	WebServer::_handleNewConnection( int listenerFd )
 {
 	struct sockaddr_storage client;
-	unsigned int 			sizeAddr = sizeof(client);
+	socklen_t	 			sizeAddr = sizeof(client);
 	int 					connFd = -1;
 	std::string				cliIP, cliPort;
 	char 					ip4[INET_ADDRSTRLEN], ip6[INET6_ADDRSTRLEN];
 
-	connFd = accept(listenerFd, (struct sockaddr *) &client, &sizeAddr);
-	if (client.ss_family == AF_INET)
-	{
-		inet_ntop(AF_INET, &(((struct sockaddr_in*) &client)->sin_addr), ip4, INET_ADDRSTRLEN);
-		cliIP = std::string(ip4);
-		cliPort = std::to_string(ntohs(((struct sockaddr_in*) &client)->sin_port));
-	}
-	else if (client.ss_family == AF_INET6)
-	{
-		inet_ntop(AF_INET6, &(((struct sockaddr_in6*) &client)->sin6_addr), ip6, INET6_ADDRSTRLEN);
-		cliIP = std::string(ip6);
-		cliPort = std::to_string(ntohs(((struct sockaddr_in6*) &client)->sin6_port));
-	}
-	if (connFd == -1)
-		std::cerr << C_RED  << "connection with client: " << cliIP << ":" << cliPort << " failed" << C_RESET << '\n';
-	else
+	for (int accepted = 0; accepted < ACCEPT_BATCH; accepted++)		// drain the queue, what is left is reported again by the poller
 	{
-		fcntl(connFd, F_SETFL, O_NONBLOCK);
-		this->_addConn(connFd, CLIENT_CONNECTION, READ_REQ_HEADER, this->_pollitems[listenerFd]->servIP, this->_pollitems[listenerFd]->servPort, cliIP, cliPort);
+		sizeAddr = sizeof(client);
+		connFd = accept4(listenerFd, (struct sockaddr *) &client, &sizeAddr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (connFd == -1)
+		{
+			if ((errno != EAGAIN) and (errno != EWOULDBLOCK) and (errno != ECONNABORTED) and (errno != EINTR))
+				std::cerr << C_RED  << "accept failed: " << std::strerror(errno) << C_RESET << '\n';
+			if (errno == ECONNABORTED or errno == EINTR)
+				continue ;
+			return ;
+		}
+		if (client.ss_family == AF_INET)
+		{
+			inet_ntop(AF_INET, &(((struct sockaddr_in*) &client)->sin_addr), ip4, INET_ADDRSTRLEN);
+			cliIP = std::string(ip4);
+			cliPort = std::to_string(ntohs(((struct sockaddr_in*) &client)->sin_port));
+		}
+		else if (client.ss_family == AF_INET6)
+		{
+			inet_ntop(AF_INET6, &(((struct sockaddr_in6*) &client)->sin6_addr), ip6, INET6_ADDRSTRLEN);
+			cliIP = std::string(ip6);
+			cliPort = std::to_string(ntohs(((struct sockaddr_in6*) &client)->sin6_port));
+		}
+		try {
+			this->_addConn(connFd, CLIENT_CONNECTION, READ_REQ_HEADER, _getPollItem(listenerFd)->servIP, _getPollItem(listenerFd)->servPort, cliIP, cliPort);
+		}
+		catch (const std::exception& e) {
+			std::cerr << C_RED  << "connection with client: " << cliIP << ":" << cliPort << " failed: " << e.what() << C_RESET << '\n';
+			close(connFd);
+			continue ;
+		}
+		_armTimer(connFd, TIMER_HEADER);
 		std::cout << C_GREEN << "connected to client: " << cliIP << ":" << cliPort << C_RESET << '\n';
 	}
 }
 
 void	WebServer::_readRequestHead( int clientSocket )
 {
+	t_PollItem		*client = _getPollItem(clientSocket);
 	HTTPrequest 	*request = nullptr;
 	HTTPresponse	*response = nullptr;
-	CGI				*cgi = nullptr;
 	fdState			nextStatus;
 
-	if (this->_requests[clientSocket] == nullptr)
-		this->_requests[clientSocket] = new HTTPrequest(clientSocket, _getServersFromIP(this->_pollitems[clientSocket]->servIP, this->_pollitems[clientSocket]->servPort));
-	request = this->_requests[clientSocket];
+	if (client->request == nullptr)
+	{
+		client->request = new HTTPrequest(clientSocket, _getServersFromIP(client->servIP, client->servPort), std::move(client->pending), &this->_openFiles);
+		client->pending.clear();
+		if (client->timer.type == TIMER_KEEPALIVE)		// a new request is coming in
+			_armTimer(clientSocket, TIMER_HEADER);
+	}
+	request = client->request;
 	request->parseHead();
 	if (request->isDoneReadingHead())
 	{
 		response = new HTTPresponse(request->getSocket(), request->getStatusCode(), request->getType());
-		this->_responses[clientSocket] = response;
-		response->setTargetFile(request->getRealPath());
+		client->response = response;
+		response->setCompression(&request->getGzip(), (request->getAcceptedCodings() & CODING_GZIP) != 0, &this->_gzipCache);
+		response->setContentTypes(&this->_mimeTypes, &request->getTypesConf());
+		response->setTargetFile(request->getRealPath(), &this->_fileCache, &this->_openFiles,
+			request->getStaticCodings(), request->getAcceptedCodings());
 		response->setRoot(request->getRoot());
-		if (request->isCGI())		// GET cgi, POST
+		if (request->isStatic() == true)		// a copy still valid on the client makes the body useless, a range cuts it
 		{
-			cgi = new CGI(*request);
-			this->_addConn(cgi->getResponsePipe()[0], CGI_RESPONSE_PIPE_READ_END, READ_CGI_RESPONSE);
-			if (request->isFastCGI() == true)
-			{
-				close(cgi->getUploadPipe()[0]);
-				close(cgi->getUploadPipe()[1]);
-			}
-			else if (request->isFileUpload())
-				this->_addConn(cgi->getUploadPipe()[1], CGI_REQUEST_PIPE_WRITE_END, WRITE_TO_CGI);
-			this->_cgi[clientSocket] = cgi;
-			cgi->run();
+			if (response->checkConditions(request->getIfNoneMatch(), request->getIfModifiedSince()) == false)
+				response->setRanges(request->getRange(), request->getIfRange());
 		}
-		else if (request->isStatic())		// GET static
-			_addConn(response->getHTMLfd(), STATIC_FILE, READ_STATIC_FILE);
+		if (request->isCGI() and ((request->isBodyBuffered() == false) or (request->hasBodyToRead() == false)))		// GET cgi, POST
+			_runCGI(clientSocket);
+		else if (request->isStatic() and (response->getBodyFd() != -1))		// GET static, not a regular file: polled and sent as it is read
+			_addAuxConn(response->getBodyFd(), STATIC_FILE, READ_STATIC_FILE, clientSocket);
 		if (request->isAutoIndex() or request->isRedirection() or request->isDelete())		// nothing more to do, send response
 			nextStatus = WRITE_TO_CLIENT;
 		else if (request->isFastCGI())														// run CGI
 			nextStatus = WAIT_FOR_CGI;
 		else if (request->hasBodyToRead())													// read request body (file upload)
 			nextStatus = READ_REQ_BODY;
-		else if (request->isStatic())														// read static file
-			nextStatus = READ_STATIC_FILE;
+		else if (request->isStatic())														// head goes out now, the body follows from its source
+			nextStatus = WRITE_TO_CLIENT;
 		else																				// request body already read, run CGi (file upload)
-			nextStatus = READ_CGI_RESPONSE;
-		this->_pollitems[clientSocket]->pollState = nextStatus;
+			nextStatus = WAIT_FOR_CGI;
+		_setState(clientSocket, nextStatus);
+		if ((nextStatus == READ_REQ_BODY) and (request->hasPendingInput()))		// body of a pipelined request already received
+			_readRequestBody(clientSocket);
 	}
 }
 
-void	WebServer::_readStaticFile( int staticFileFd )
+void	WebServer::_runCGI( int clientSocket )
 {
-	int 			socket = _getSocketFromFd(staticFileFd);
-	HTTPresponse	*response = this->_responses.at(socket);
-
-	if (this->_pollitems[staticFileFd]->pollType != STATIC_FILE)
-		return ;
-	response->readStaticFile();
-	if (response->isDoneReadingHTML() == true)
+	t_PollItem		*client = _getPollItem(clientSocket);
+	HTTPrequest 	*request = client->request;
+	CGI				*cgi = new CGI(*request);
+
+	client->cgi = cgi;
+	client->response->setBodySource(new PipeSource(cgi->getResponsePipe()[0]));
+	this->_addAuxConn(cgi->getResponsePipe()[0], CGI_RESPONSE_PIPE_READ_END, READ_CGI_RESPONSE, clientSocket);
+	_armTimer(cgi->getResponsePipe()[0], TIMER_CGI);
+	if (request->isFastCGI() == true)
 	{
-		_dropConn(staticFileFd);
-		this->_pollitems[socket]->pollState = WRITE_TO_CLIENT;
+		cgi->closeUploadReadEnd();
+		close(cgi->getUploadPipe()[1]);
 	}
+	else if (request->isFileUpload() and (request->isBodySpilled() == false))		// a spilled body is read by the CGI from its file
+	{
+		if (request->hasBodyToWrite())
+			this->_addAuxConn(cgi->getUploadPipe()[1], CGI_REQUEST_PIPE_WRITE_END, WRITE_TO_CGI, clientSocket);
+		else if (request->hasBodyToRead())
+			this->_addAuxConn(cgi->getUploadPipe()[1], CGI_REQUEST_PIPE_WRITE_END, WAIT_FOR_REQ_BODY, clientSocket);
+		else		// empty body, the CGI gets EOF right away
+			close(cgi->getUploadPipe()[1]);
+	}
+	cgi->run();
+	cgi->closeUploadReadEnd();
+}
+
+void	WebServer::_readStaticFile( int staticFileFd )
+{
+	int 	socket = _getSocketFromFd(staticFileFd);
+
+	_getPollItem(socket)->response->fillBody();
+	_updateBodySource(staticFileFd, socket);
 }
 
 void	WebServer::_readRequestBody( int clientSocket )
 {
-	HTTPrequest *request = this->_requests.at(clientSocket);
-	if (request->getTmpBody() == "")
+	t_PollItem	*client = _getPollItem(clientSocket);
+	HTTPrequest *request = client->request;
+
+	_armTimer(clientSocket, TIMER_BODY);
+	if (request->isBodyStreamed() == true)		// piped to the CGI while it arrives
+	{
+		do
+			request->parseBody();
+		while (request->hasBodyToRead() and request->canReadBody() and request->hasPendingInput());
+		if (request->hasBodyToWrite())
+			_setState(client->cgi->getUploadPipe()[1], WRITE_TO_CGI);
+		if (request->hasBodyToRead() == false)
+			_waitForCGI(clientSocket);
+		else if (request->canReadBody() == false)		// stop reading the socket until the CGI drains the buffer
+			_setState(clientSocket, WAIT_FOR_CGI_INPUT);
+		return ;
+	}
+	do
 		request->parseBody();
+	while (request->hasBodyToRead() and request->hasPendingInput());
+	if (request->isDoneReadingBody())		// whole body collected, the CGI can start
+	{
+		_runCGI(clientSocket);
+		_setState(clientSocket, WAIT_FOR_CGI);
+	}
 }
 
 void	WebServer::_writeToCGI( int cgiPipe )
 {
-	int socket = _getSocketFromFd(cgiPipe);
-	HTTPrequest *request = this->_requests.at(socket);
-	ssize_t		readChars = -1;
+	int			socket = _getSocketFromFd(cgiPipe);
+	HTTPrequest	*request = _getPollItem(socket)->request;
 
-	close(this->_cgi.at(request->getSocket())->getUploadPipe()[0]); // close read end of cgi upload pipe
-	std::string tmpBody = request->getTmpBody();
-	if (tmpBody != "")
+	request->writeBody(cgiPipe);		// a short write leaves the rest for the next POLLOUT
+	if ((request->hasBodyToWrite() == false) and (request->isDoneReadingBody() == true))
 	{
-		readChars = write(cgiPipe, tmpBody.data(), tmpBody.length());
-		if (readChars < 0)
-			throw(ServerException({"unavailable socket"}));
-		request->setTmpBody("");
-		if (request->isDoneReadingBody())
-		{
-			_dropConn(cgiPipe);
-			this->_pollitems.at(request->getSocket())->pollState = WAIT_FOR_CGI;
-		}
+		_dropConn(cgiPipe);
+		_waitForCGI(socket);
+		return ;
+	}
+	if (request->hasBodyToWrite() == false)		// drained, wait for the client to send more
+		_setState(cgiPipe, WAIT_FOR_REQ_BODY);
+	if ((_getPollItem(socket)->pollState == WAIT_FOR_CGI_INPUT) and (request->canReadBody() == true))		// room again, resume reading the client
+	{
+		_setState(socket, READ_REQ_BODY);
+		if (request->hasPendingInput() == true)		// the socket will not signal bytes that were already received
+			_readRequestBody(socket);
 	}
 }
 
 void	WebServer::_readCGIresponse( int cgiPipe )
 {
-	int 	socket = _getSocketFromFd(cgiPipe);
-	CGI		*cgi = this->_cgi.at(socket);
-	ssize_t	readChars = -1;
-	char 	buffer[HTTP_BUF_SIZE];
+	int 		socket = _getSocketFromFd(cgiPipe);
+	t_PollItem	*client = _getPollItem(socket);
+
+	client->response->fillBody();
+	if (client->response->isBodyProduced() == true)
+		client->cgi->waitCGIproc();		// reports a failed CGI, nothing to check yet if it still runs
+	_updateBodySource(cgiPipe, socket);
+}
 
-	if (cgi->waitCGIproc() == true)  // check if CGI is done
+// after a read of the source: the client gets what it produced, the source is
+// dropped once it has nothing left or parked at the high watermark
+void	WebServer::_updateBodySource( int sourceFd, int clientSocket )
+{
+	t_PollItem		*client = _getPollItem(clientSocket);
+	HTTPresponse	*response = client->response;
+
+	if ((response->isParsingNeeded() == false) and ((client->pollState == WAIT_FOR_CGI) or (client->pollState == WAIT_FOR_RESP_BODY)))
+		_setState(clientSocket, WRITE_TO_CLIENT);
+	if (response->isBodyProduced() == true)
+		_dropConn(sourceFd);
+	else if (response->isBodyBufferFull() == true)
 	{
-		std::fill(buffer, buffer + HTTP_BUF_SIZE, 0);
-		readChars = read(cgiPipe, buffer, HTTP_BUF_SIZE);
-		if (readChars < 0)
-			throw(ServerException({"unavailable socket"}));
-		cgi->appendResponse(std::string(buffer, buffer + readChars));
-		if (readChars < HTTP_BUF_SIZE)
-		{
-			_dropConn(cgiPipe);
-			this->_pollitems[socket]->pollState = WRITE_TO_CLIENT;
-		}
+		_setState(sourceFd, WAIT_FOR_RESP_SPACE);
+		if (client->pollState == WRITE_TO_CLIENT)		// the send timeout covers the wait
+			this->_timers.cancel(_getPollItem(sourceFd)->timer);
 	}
+}
+
+// the client drained the buffer to the low watermark, the parked source is read again
+void	WebServer::_resumeBodySource( int clientSocket )
+{
+	HTTPresponse	*response = _getPollItem(clientSocket)->response;
+	t_PollItem		*source = nullptr;
+	int				sourceFd = response->getBodyFd();
+
+	if ((sourceFd == -1) or (response->needsBody() == false))
+		return ;
+	source = _getPollItem(sourceFd);
+	if (source->pollState != WAIT_FOR_RESP_SPACE)
+		return ;
+	if (source->pollType == CGI_RESPONSE_PIPE_READ_END)
+	{
+		_setState(sourceFd, READ_CGI_RESPONSE);
+		_armTimer(sourceFd, TIMER_CGI);
+	}
+	else
+		_setState(sourceFd, READ_STATIC_FILE);
+}
 
+// the CGI may have answered while the request body was still coming in
+void	WebServer::_waitForCGI( int clientSocket )
+{
+	if (_getPollItem(clientSocket)->response->isParsingNeeded() == false)
+		_setState(clientSocket, WRITE_TO_CLIENT);
+	else
+		_setState(clientSocket, WAIT_FOR_CGI);
 }
 
 void	WebServer::_writeToClient( int clientSocket )
 {
-	HTTPrequest 	*request = this->_requests.at(clientSocket);
-	HTTPresponse 	*response = this->_responses.at(clientSocket);
+	t_PollItem		*client = _getPollItem(clientSocket);
+	HTTPrequest 	*request = client->request;
+	HTTPresponse 	*response = client->response;
 
-	if (response->isParsingNeeded())
+	_armTimer(clientSocket, TIMER_SEND);
+	if (response->isParsingNeeded() and (response->isCGI() == false))		// a CGI head is parsed as it is read
 	{
-		if (response->isCGI())
-			response->parseCGI(this->_cgi.at(clientSocket)->getResponse());
-		else
+		if (response->isAutoIndex())
+			response->listContentDirectory();
+		else if (response->isDelete())
 		{
-			if (response->isAutoIndex())
-				response->listContentDirectory();
-			else if (response->isDelete())
-				response->removeFile();
-			response->parseNotCGI(request->getServName());
+			response->removeFile();
+			this->_fileCache.forget(request->getRealPath());
+			this->_openFiles.forget(request->getRealPath());
 		}
+		response->parseNotCGI(request->getServerHeader());
 	}
 	response->writeContent();
 	if (response->isDoneWriting())
 	{
-		if ((request->isEndConn()) or (request->getStatusCode() == 444))		// NGINX custom behaviour, if code == 444 connection is closed as well
+		if ((request->isEndConn()) or (request->getStatusCode() == 444)		// NGINX custom behaviour, if code == 444 connection is closed as well
+			or (request->isBodyLeftUnread()))									// the next request would start inside this body
 			_dropConn(clientSocket);
 		else
 		{
+			client->pending = request->takeSurplus();
+			_dropAuxConns(clientSocket);		// a CGI may still be running past its Content-Length
 			_clearStructs(clientSocket);
-			this->_pollitems[clientSocket]->pollState = READ_REQ_HEADER;
+			_setState(clientSocket, READ_REQ_HEADER);
+			if (client->pending.empty() == false)		// pipelined request already received, no readiness event will come for it
+				_readRequestHead(clientSocket);
 		}
 	}
+	else
+	{
+		_resumeBodySource(clientSocket);
+		if (response->isWaitingForBody() == true)
+			_setState(clientSocket, WAIT_FOR_RESP_BODY);
+	}
 }
 
 void	WebServer::_redirectToErrorPage( int genericFd, int statusCode ) noexcept
 {
 	int				clientSocket = _getSocketFromFd(genericFd);
-	HTTPrequest		*request = this->_requests[clientSocket];
+	t_PollItem		*client = _getPollItem(clientSocket);
+	HTTPrequest		*request = client->request;
 	HTTPresponse	*response = nullptr;
 	path_t			HTMLerrPage;
 
-	if (this->_pollitems[genericFd]->pollType > CLIENT_CONNECTION)	// when genericFd refers to a pipe or a static file
+	if (_getPollItem(genericFd)->pollType > CLIENT_CONNECTION)	// when genericFd refers to a pipe or a static file
 		_dropConn(genericFd);
+	else if ((client->cgi != nullptr) and (request->isFileUpload()) and (request->isDoneReadingBody() == false))
+	{		// body rejected while the CGI is still reading it
+		client->cgi->killCGIproc();
+		_dropAuxConns(clientSocket);
+	}
 	else if (statusCode == 444)		// NGINX custom behaviour: close connection without sending a response
 	{
 		_dropConn(clientSocket);
-		this->_pollitems[clientSocket]->pollState = READ_REQ_HEADER;
+		_setState(clientSocket, READ_REQ_HEADER);
+		return ;
+	}
+	if (client->response == nullptr)
+		client->response = new HTTPresponse(request->getSocket(), statusCode);
+	else if (client->response->hasStartedWriting() == true)		// part of the response is out, the client can only be cut off
+	{
+		_dropConn(clientSocket);
 		return ;
 	}
-	if (this->_responses[clientSocket] == nullptr)
-		this->_responses[clientSocket] = new HTTPresponse(request->getSocket(), statusCode);
-	response = this->_responses[clientSocket];
+	response = client->response;
+	_dropAuxConns(clientSocket);		// sources of the failed response
 	try {
 		request->updateErrorCode(statusCode);
 		HTMLerrPage = request->getRealPath();
@@ -552,7 +837,7 @@ void	WebServer::_redirectToErrorPage( int genericFd, int statusCode ) noexcept
 			if (statusCode == 500)
 			{
 				response->errorReset(statusCode, true);
-				this->_pollitems[clientSocket]->pollState = WRITE_TO_CLIENT;
+				_setState(clientSocket, WRITE_TO_CLIENT);
 			}
 			else
 				_redirectToErrorPage(clientSocket, 500);
@@ -560,7 +845,9 @@ void	WebServer::_redirectToErrorPage( int genericFd, int statusCode ) noexcept
 		}
 	}
 	response->errorReset(statusCode, false);
-	response->setTargetFile(HTMLerrPage);
-	_addConn(response->getHTMLfd(), STATIC_FILE, READ_STATIC_FILE);
-	this->_pollitems[clientSocket]->pollState = READ_STATIC_FILE;
+	response->setContentTypes(&this->_mimeTypes, &request->getTypesConf());
+	response->setTargetFile(HTMLerrPage, &this->_fileCache, &this->_openFiles);
+	if (response->getBodyFd() != -1)		// not a regular file, polled and sent as it is read
+		_addAuxConn(response->getBodyFd(), STATIC_FILE, READ_STATIC_FILE, clientSocket);
+	_setState(clientSocket, WRITE_TO_CLIENT);
 }
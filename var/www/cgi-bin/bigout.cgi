@@ -0,0 +1,6 @@
+#!/usr/bin/env python3
+import sys
+n=200*1024*1024
+sys.stdout.write("Status: 200 OK\r\nServer: t\r\nContent-Type: application/octet-stream\r\nContent-Length: %d\r\n\r\n"%n); sys.stdout.flush()
+b=b'x'*65536
+for i in range(n//65536): sys.stdout.buffer.write(b)